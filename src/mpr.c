@@ -21,6 +21,7 @@ Mpr *mprCreate(int argc, char **argv, int flags)
 {
     MprFileSystem   *fs;
     Mpr             *mpr;
+    cchar           *cp;
 
     srand((uint) time(NULL));
 
@@ -85,11 +86,18 @@ Mpr *mprCreate(int argc, char **argv, int flags)
     mpr->cmdService = mprCreateCmdService();
     mpr->workerService = mprCreateWorkerService();
     mpr->waitService = mprCreateWaitService();
+    mpr->eventService->waitService = mpr->waitService;
     mpr->socketService = mprCreateSocketService();
 
     mpr->dispatcher = mprCreateDispatcher("main", 1);
     mpr->nonBlock = mprCreateDispatcher("nonblock", 1);
     mpr->pathEnv = sclone(getenv("PATH"));
+    if ((cp = getenv("MPR_EVENT_LOOPS")) != 0) {
+        mprSetEventLoops(atoi(cp));
+    }
+    if ((cp = getenv("MPR_EVENT_STATS")) != 0 && atoi(cp) > 0) {
+        mprSetEventStats(1);
+    }
 
     if (flags & MPR_USER_EVENTS_THREAD) {
         if (!(flags & MPR_NO_WINDOW)) {
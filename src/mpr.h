@@ -46,6 +46,9 @@
 #ifndef BIT_FLOAT
     #define BIT_FLOAT 1
 #endif
+#ifndef BIT_HAS_IO_URING
+    #define BIT_HAS_IO_URING 0
+#endif
 #ifndef BIT_ROM
     #define BIT_ROM 0
 #endif
@@ -322,6 +325,17 @@
 
 #if LINUX
     #include    <sys/epoll.h>
+    #include    <sys/eventfd.h>
+    #include    <sys/syscall.h>
+    #if BIT_HAS_IO_URING && defined(__has_include)
+        #if __has_include(<linux/io_uring.h>)
+            #include    <linux/io_uring.h>
+        #endif
+    #endif
+#endif
+
+#if (LINUX && !__UCLIBC__) || MACOSX
+    #include    <execinfo.h>
 #endif
 
 #if BIT_UNIX_LIKE
@@ -1305,6 +1319,7 @@ struct  MprXml;
 
 #define MPR_TIMEOUT_PRUNER      600000      /**< Time between worker thread pruner runs (10 min) */
 #define MPR_TIMEOUT_WORKER      300000      /**< Prune worker that has been idle for 5 minutes */
+#define MPR_TIMEOUT_ADAPT       1000        /**< Time between adaptive worker pool adjustments */
 #define MPR_TIMEOUT_START_TASK  10000       /**< Time to start tasks running */
 #define MPR_TIMEOUT_STOP        30000       /**< Default wait when stopping resources (30 sec) */
 #define MPR_TIMEOUT_STOP_TASK   10000       /**< Time to stop or reap tasks (vxworks) */
@@ -2014,8 +2029,8 @@ extern void *mprAtomicExchange(void * volatile *target, cvoid *value);
  */
 typedef struct MprMem {
     /*
-        Accesses to field1 must only be done while locked. This includes read access as concurrent writes may leave 
-        field1 in a partially updated state. Access to field2 may be done while unlocked as only the marker updates 
+        Updates to field1 are done atomically as a block may be allocated (setting hasManager) while a sweeper 
+        coalesces its neighbour (setting prior). Access to field2 may be done while unlocked as only the marker updates 
         active blocks and it does so, in a lock-free manner.
 
             field1: prior | last << 1 | hasManager
@@ -2053,6 +2068,42 @@ typedef struct MprMem {
 #define MPR_ALLOC_BITS_PER_GROUP    (sizeof(void*) * 8)
 #define MPR_ALLOC_NUM_GROUPS        (MPR_ALLOC_BITS_PER_GROUP - MPR_ALLOC_BUCKET_SHIFT - MPR_ALIGN_SHIFT - 1)
 #define MPR_ALLOC_NUM_BUCKETS       (1 << MPR_ALLOC_BUCKET_SHIFT)
+
+/*
+    Per-thread allocation caches. The lowest free queues each hold blocks of exactly one size. Threads cache blocks
+    for these queues privately and refill from (and drain to) the heap free queues in batches.
+ */
+#define MPR_ALLOC_CACHE_QUEUES      32          /**< Number of small block queues cached per thread */
+#define MPR_ALLOC_CACHE_BATCH       16          /**< Number of blocks transferred per cache refill */
+#define MPR_SLAB_SIZE               (64 * 1024) /**< Size of slab regions for small block sizes */
+#define MPR_ARENA_SIZE              (64 * 1024) /**< Default arena chunk size */
+
+/*
+    Parallel marking. Marker threads share work via per-marker mark stacks and steal from each other when idle.
+    The pause time budget is enforced between collections by adapting the number of markers engaged.
+ */
+#define MPR_MAX_MARKERS             8           /**< Maximum number of marker threads (including the primary marker) */
+#define MPR_MARK_STACK_SIZE         (64 * 1024) /**< Initial mark stack size in entries */
+#define MPR_MARK_STEAL              64          /**< Maximum number of entries stolen at a time */
+#define MPR_GC_PAUSE_BUDGET         10          /**< Default GC pause time budget in msec */
+#define MPR_GC_PAUSE_BUCKETS        12          /**< Number of GC pause histogram buckets */
+#define MPR_GC_MINOR_CYCLES         8           /**< Nursery minor collections between full collections */
+
+/*
+    Region placement policy flags for mprSetMemPlacement
+ */
+#define MPR_MEM_HUGE_PAGES          0x1         /**< Align regions for transparent huge pages */
+#define MPR_MEM_NUMA                0x2         /**< Prefer the NUMA node of the allocating thread for regions */
+#define MPR_MEM_DONTNEED            0x4         /**< Return the pages of completely free regions to the O/S */
+#define MPR_HUGE_PAGE_SIZE          (2 * 1024 * 1024) /**< Transparent huge page size */
+
+/*
+    Sampling allocation profiler. A stack is recorded for one allocation in every interval of allocated bytes.
+ */
+#define MPR_MEM_PROFILE_INTERVAL    (512 * 1024) /**< Default bytes allocated between profile samples */
+#define MPR_MEM_PROFILE_DEPTH       32          /**< Maximum stack frames recorded per sample */
+#define MPR_MEM_PROFILE_SITES       4096        /**< Maximum number of distinct allocation sites */
+#define MPR_MEM_PROFILE_SAMPLES     (16 * 1024) /**< Maximum number of live sampled blocks */
 #define MPR_GET_PTR(bp)             ((void*) (((char*) (bp)) + sizeof(MprMem)))
 #define MPR_GET_MEM(ptr)            ((MprMem*) (((char*) (ptr)) - sizeof(MprMem)))
 #define MPR_GET_GEN(mp)             ((mp->field2 & MPR_MASK_GEN) >> MPR_SHIFT_GEN)
@@ -2061,6 +2112,7 @@ typedef struct MprMem {
 /*
     GC Object generations
  */
+#define MPR_GEN_OLD                 0           /**< Blocks promoted from the nursery. See mprSetGCNursery */
 #define MPR_GEN_ETERNAL             3           /**< Objects immune from collection */
 #define MPR_MAX_GEN                 3           /**< Number of generations for object allocation */
 
@@ -2177,6 +2229,19 @@ typedef struct MprMemStats {
     int             marked;
     int             sweepVisited;
     int             swept;
+    ssize           cached;                 /**< Bytes currently held in per-thread allocation caches */
+    uint64          cacheHits;              /**< Count of allocations satisfied from a per-thread cache */
+    uint64          cacheRefills;           /**< Count of batch refills of per-thread caches from the heap */
+    uint64          cacheDrains;            /**< Count of per-thread caches drained back to the heap */
+    int             markers;                /**< Number of markers used in the last collection */
+    MprTime         pauseBudget;            /**< Target maximum collection pause (msec). Pauses are in MprGCStats */
+    uint64          pauseOverruns;          /**< Count of collections that exceeded the pause budget */
+    uint64          markSteals;             /**< Count of work steals between markers */
+    uint64          lazySweeps;             /**< Count of regions swept on demand by allocating threads */
+    uint64          slabAllocs;             /**< Count of blocks allocated from slab regions */
+    int             slabs;                  /**< Count of slab regions */
+    uint64          releases;               /**< Count of free regions whose pages were returned to the O/S */
+    ssize           contention;             /**< Count of heap and free queue lock acquisitions that had to wait */
 
 #if BIT_MEMORY_STATS
     /*
@@ -2194,6 +2259,36 @@ typedef struct MprMemStats {
 } MprMemStats;
 
 
+/**
+    Garbage collector statistics
+    @description Durations are in milliseconds. Pauses include the time waiting for threads to yield, marking and 
+        any sweeping done while threads are paused.
+    @ingroup MprMem
+ */
+typedef struct MprGCStats {
+    uint64          cycles;                 /**< Count of completed collections */
+    uint64          pauseHistogram[MPR_GC_PAUSE_BUCKETS]; /**< Count of pauses by duration. Bucket N counts pauses 
+                                                 shorter than 2^N msec. The last bucket counts all longer pauses */
+    MprTime         lastPause;              /**< Duration of the last pause */
+    MprTime         maxPause;               /**< Longest pause */
+    MprTime         totalPause;             /**< Total of all pauses */
+    MprTime         lastSync;               /**< Time waiting for threads to yield for the last collection */
+    MprTime         totalSync;              /**< Total time waiting for threads to yield */
+    MprTime         lastMark;               /**< Duration of marking for the last collection */
+    MprTime         totalMark;              /**< Total time marking */
+    MprTime         lastSweep;              /**< Duration of sweeping while paused for the last collection */
+    MprTime         totalSweep;             /**< Total time sweeping while paused */
+    ssize           lastReclaimed;          /**< Bytes reclaimed by the last completed sweep */
+    uint64          totalReclaimed;         /**< Total bytes reclaimed */
+    uint64          growths;                /**< Count of heap growth events (new regions) */
+    ssize           lastGrowth;             /**< Size of the last heap growth */
+    MprTime         lastGrowthTime;         /**< Time of the last heap growth */
+    uint64          minorCycles;            /**< Count of nursery minor collections */
+    ssize           lastDirty;              /**< Old blocks rescanned by the last minor collection */
+    uint64          minorRetains;           /**< Minor collections that retained all young blocks */
+} MprGCStats;
+
+
 /**
    Memmory regions allocated from the O/S
     @ingroup MemMem
@@ -2204,26 +2299,147 @@ typedef struct MprRegion {
     MprSpin          lock;                  /**< Region multithread lock */
     ssize            size;                  /**< Size of region including region header */
     int              freeable;              /**< Set to true when completely unused */
+    ulong            *slabMap;              /**< Slab free block bitmap. Null if not a slab region */
+    struct MprRegion *nextSlab;             /**< Next slab of the same block size with free blocks */
+    struct MprRegion *prevSlab;             /**< Prior slab of the same block size with free blocks */
+    ssize            slabSize;              /**< Slab block size */
+    int              slabCount;             /**< Number of blocks in the slab */
+    int              slabFree;              /**< Number of free blocks in the slab */
+    int              slabIndex;             /**< Free queue index for the slab block size */
 } MprRegion;
 
 
+/**
+    Per-thread memory allocation cache
+    @description Each MprThread owns a cache of free blocks for the smallest block sizes. Cached blocks are removed
+        from the heap free queues and are owned by the thread so they can be allocated without taking the heap lock.
+    @ingroup MemMem
+ */
+typedef struct MprMemCache {
+    MprFreeMem       *freeq[MPR_ALLOC_CACHE_QUEUES];  /**< Singly linked lists of cached blocks */
+    int              count[MPR_ALLOC_CACHE_QUEUES];   /**< Count of blocks on each cache list */
+    uint64           hits;                            /**< Allocations satisfied from this cache */
+    ssize            sampleBytes;                     /**< Bytes to allocate before the next profile sample */
+} MprMemCache;
+
+
+/**
+    Parallel marker work stack
+    @description Each marker thread owns a stack of blocks whose managers must be run. Idle markers steal work
+        from the stacks of other markers.
+    @ingroup MemMem
+ */
+typedef struct MprMarkStack {
+    MprSpin          lock;                   /**< Stack lock (owner push/pop and stealing) */
+    cvoid            **items;                /**< Blocks to mark (allocated from virtual memory) */
+    ssize            size;                   /**< Size of items in entries */
+    ssize            top;                    /**< Index of next free entry */
+    struct MprThread *thread;                /**< Helper marker thread (null for the primary marker) */
+    MprCond          *cond;                  /**< Wakeup for the helper marker thread */
+    int              iteration;              /**< GC iteration last marked by this marker */
+    int              marked;                 /**< Blocks marked by this marker in the current collection */
+} MprMarkStack;
+
+
+/**
+    Allocation site recorded by the memory profiler
+    @ingroup MemMem
+ */
+typedef struct MprMemSite {
+    void             *frames[MPR_MEM_PROFILE_DEPTH]; /**< Call stack with the innermost frame first */
+    int              depth;                  /**< Number of frames */
+    int              used;                   /**< Site slot is in use */
+    uint             hash;                   /**< Hash of the call stack */
+    int              count;                  /**< Count of live sampled blocks */
+    ssize            live;                   /**< Estimated live bytes allocated from this site */
+    ssize            allocated;              /**< Estimated total bytes allocated from this site */
+} MprMemSite;
+
+
+/**
+    Sampled block tracked by the memory profiler
+    @ingroup MemMem
+ */
+typedef struct MprMemSample {
+    MprMem           *mp;                    /**< Sampled block */
+    ssize            weight;                 /**< Estimated bytes represented by this sample */
+    int              site;                   /**< Index of the allocation site */
+} MprMemSample;
+
+
+/**
+    Sampling allocation profiler state. Allocated from virtual memory so profiling never recurses into the heap.
+    @ingroup MemMem
+ */
+typedef struct MprMemProfile {
+    MprSpin          lock;                   /**< Lock for sites and samples */
+    MprMemSite       *sites;                 /**< Hash table of allocation sites */
+    MprMemSample     *samples;               /**< Live sampled blocks */
+    ssize            interval;               /**< Bytes allocated between samples */
+    ssize            sampleBytes;            /**< Bytes to allocate before the next sample by foreign threads */
+    int              siteCount;              /**< Number of sites in use */
+    int              sampleCount;            /**< Number of live samples */
+    uint64           taken;                  /**< Count of samples taken */
+    uint64           dropped;                /**< Count of samples dropped because the tables were full */
+} MprMemProfile;
+
+
+/**
+    Region scanned by a minor collection
+    @ingroup MemMem
+ */
+typedef struct MprNurseryRegion {
+    char             *start;                 /**< Start of the region */
+    char             *end;                   /**< End of the region */
+    ssize            base;                   /**< Index of the first bit for the region in the young block map */
+} MprNurseryRegion;
+
+
+/**
+    Minor collection scan tables. Allocated from virtual memory and grown as the heap grows.
+    @ingroup MemMem
+ */
+typedef struct MprNursery {
+    MprNurseryRegion *regions;               /**< Regions sorted by address */
+    ssize            regionMax;              /**< Size of regions in entries */
+    int              regionCount;            /**< Number of regions in use */
+    ulong            *young;                 /**< Bitmap of young block headers. One bit per MPR_ALIGN bytes */
+    ssize            youngMax;               /**< Size of young in words */
+    MprMem           **dirty;                /**< Old blocks on modified pages */
+    ssize            dirtyMax;               /**< Size of dirty in entries */
+    ssize            dirtyCount;             /**< Number of dirty entries */
+    MprMem           **scan;                 /**< Young blocks without managers awaiting a conservative scan */
+    ssize            scanMax;                /**< Size of scan in entries */
+    ssize            scanCount;              /**< Number of scan entries */
+    MprMem           **suspects;             /**< Young blocks with managers found by conservative scanning */
+    ssize            suspectMax;             /**< Size of suspects in entries */
+    ssize            suspectCount;           /**< Number of suspect entries */
+    uint64           *pages;                 /**< Page map entries for the region being scanned */
+    ssize            pageMax;                /**< Size of pages in entries */
+} MprNursery;
+
+
 /**
     Memory allocator heap
     @ingroup MemMem
  */
 typedef struct MprHeap {
     MprFreeMem       freeq[MPR_ALLOC_NUM_GROUPS * MPR_ALLOC_NUM_BUCKETS];
-    ulong            bucketMap[MPR_ALLOC_NUM_GROUPS];
+    MprSpin          freeLocks[MPR_ALLOC_NUM_GROUPS * MPR_ALLOC_NUM_BUCKETS];  /**< Per free queue locks */
+    volatile ssize   bucketMap[MPR_ALLOC_NUM_GROUPS];   /**< Non-empty buckets per group. Updated atomically */
     MprFreeMem       *freeEnd;
-    ssize            groupMap;
+    volatile ssize   groupMap;               /**< Groups with non-empty buckets. Updated atomically */
     struct MprList   *roots;                 /**< List of GC root objects */
     MprMemStats      stats;
+    MprGCStats       gcStats;                /**< Garbage collector statistics */
     MprMemNotifier   notifier;               /**< Memory allocation failure callback */
     MprSpin          heapLock;               /**< Heap allocation lock */
     MprSpin          rootLock;               /**< Root locking */
     MprCond          *markerCond;            /**< Marker sleep cond var */
     MprMutex         *mutex;                 /**< Locking for state changes */
     MprRegion        *regions;               /**< List of memory regions */
+    struct MprArena  *arenas;                /**< List of live arenas. Traced by minor collections */
+    MprMemProfile    *profile;               /**< Sampling allocation profiler */
     struct MprThread *marker;                /**< Marker thread */
     struct MprThread *sweeper;               /**< Optional sweeper thread */
 
@@ -2231,9 +2447,13 @@ typedef struct MprHeap {
     int              active;                 /**< Active generation for new and active blocks */
     int              stale;                  /**< Stale generation for blocks that may have no references*/
     int              dead;                   /**< Dead generation (blocks about to be freed) */
+    int              old;                    /**< Old generation for blocks surviving the nursery */
 
     int              allocPolicy;            /**< Memory allocation depletion policy */
+    int              placement;              /**< Region placement policy */
+    int              profiling;              /**< Sampling allocation profiler is enabled */
     int              chunkSize;              /**< O/S memory allocation chunk size */
+    int              hugeChunkSize;          /**< O/S memory allocation chunk size when using huge pages */
     int              collecting;             /**< Manual GC is running */
     int              destroying;             /**< Destroying the heap */
     int              enabled;                /**< GC is enabled */
@@ -2257,6 +2477,29 @@ typedef struct MprHeap {
     int              scribble;               /**< Scribble over freed memory (slow) */
     int              track;                  /**< Track memory allocations */
     int              verify;                 /**< Verify memory contents (very slow) */
+    uint64           cacheHits;              /**< Cache hits accumulated from exited threads */
+    MprRegion        *slabs[MPR_ALLOC_CACHE_QUEUES]; /**< Slab regions with free blocks for each small block size */
+    MprMarkStack     markStacks[MPR_MAX_MARKERS]; /**< Parallel mark stacks. Index zero is the primary marker */
+    int              markers;                /**< Number of helper marker threads for parallel marking */
+    int              activeMarkers;          /**< Helpers participating in the current collection */
+    int              parallel;               /**< Parallel marking is active */
+    volatile int     markIdle;               /**< Count of idle markers (termination detection) */
+    volatile int     markDone;               /**< Count of helpers finished with the current collection */
+    MprRegion        *sweepNext;             /**< Next region to sweep. Regions from here on are not yet swept */
+    volatile int     sweepBusy;              /**< Count of regions being swept */
+    int              sweeping;               /**< Parallel sweep of all regions is active */
+    int              lazySweep;              /**< Free dead blocks after threads resume */
+    int              nursery;                /**< Generational collection is enabled. See mprSetGCNursery */
+    int              minor;                  /**< Current collection only traces young blocks */
+    int              minorCount;             /**< Minor collections since the last full collection */
+    int              needFull;               /**< Next collection must be a full collection */
+    int              sweepOld;               /**< Unmarked old blocks are dead in this collection */
+    int              promote;                /**< Promote survivors of this collection to the old generation */
+    int              retainYoung;            /**< Minor collection could not prove young blocks unreferenced */
+    int              softDirty;              /**< O/S dirty page tracking is available */
+    int              pagemap;                /**< File handle for /proc/self/pagemap */
+    int              clearRefs;              /**< File handle for /proc/self/clear_refs */
+    MprNursery       *nurseryState;          /**< Minor collection scan tables */
 } MprHeap;
 
 /**
@@ -2304,6 +2547,24 @@ extern void *mprAllocMem(ssize size, int flags);
  */
 extern MprMemStats *mprGetMemStats();
 
+/**
+    Return the garbage collector statistics
+    @description The statistics include a histogram of pause times, the time spent waiting for threads to yield, 
+        marking and sweeping, the bytes reclaimed and heap growth events.
+    @returns a reference to the collector statistics. Do not modify its contents.
+    @ingroup MprMem
+ */
+extern MprGCStats *mprGetGCStats();
+
+/**
+    Return the garbage collector statistics as an object tree
+    @description The object includes the statistics returned by #mprGetGCStats, the heap size and the time each 
+        thread has spent waiting in mprYield for the collector. The object may be converted to JSON via #mprSerialize.
+    @returns An object tree of MprHash objects
+    @ingroup MprMem
+ */
+extern struct MprHash *mprGetGCStatsObj();
+
 /**
     Return the amount of memory currently used by the application. On Unix, this returns the total application memory
     size including code, stack, data and heap. On Windows, VxWorks and other operatings systems, it returns the
@@ -2470,6 +2731,48 @@ extern void mprSetMemLimits(ssize redline, ssize maxMemory);
 */
 extern void mprSetMemPolicy(int policy);
 
+/**
+    Set the memory region placement policy
+    @description Control how memory regions are obtained from and returned to the O/S. These options are only
+        implemented on Linux and are ignored elsewhere.
+    @param flags Set to MPR_MEM_HUGE_PAGES to allocate regions in multiples of MPR_HUGE_PAGE_SIZE aligned for 
+        transparent huge pages. Set MPR_MEM_NUMA to prefer the NUMA node of the thread allocating a region. 
+        Set MPR_MEM_DONTNEED to return the pages of completely free regions that are retained by the heap 
+        to the O/S via madvise. 
+    @ingroup MprMem
+ */
+extern void mprSetMemPlacement(int flags);
+
+/**
+    Start the sampling allocation profiler
+    @description The profiler records the call stack of one allocation in every interval of allocated bytes. 
+        Sampled blocks are tracked until collected so the live bytes attributed to each allocation site are maintained
+        across garbage collections. Profiling has low overhead and is available in release builds. Call stacks are
+        only captured on platforms supporting backtrace(3).
+    @param interval Average number of bytes allocated between samples. Set to zero for MPR_MEM_PROFILE_INTERVAL.
+    @return Zero if successful, otherwise a negative MPR error code.
+    @ingroup MprMem
+ */
+extern int mprStartMemProfile(ssize interval);
+
+/**
+    Stop the sampling allocation profiler
+    @description Stops taking new samples. Existing samples continue to be tracked and may be dumped.
+    @ingroup MprMem
+ */
+extern void mprStopMemProfile();
+
+/**
+    Write the allocation profile to a file
+    @description Writes the estimated live bytes for each allocation site in collapsed stack format. Each line 
+        has the frames of a call stack, outermost first, separated by semicolons followed by a space and the live
+        byte count. This is the input format for flame graph tools.
+    @param path Filename for the profile.
+    @return The number of allocation sites written, otherwise a negative MPR error code.
+    @ingroup MprMem
+ */
+extern int mprDumpMemProfile(cchar *path);
+
 /**
     Update the manager for a block of memory.
     @description This call updates the manager for a block of memory allocated via mprAllocWithManager.
@@ -2583,6 +2886,7 @@ extern void mprCheckBlock(MprMem *bp);
  */
 extern void mprStartGCService();
 extern void mprStopGCService();
+extern void mprFlushMemCache(MprMemCache *cache);
 
 /******************************** Garbage Coolector ***************************/
 /**
@@ -2617,6 +2921,58 @@ extern void mprRequestGC(int flags);
  */
 extern bool mprEnableGC(bool on);
 
+/**
+    Set the number of parallel marker threads
+    @description The garbage collector marks memory using the dedicated marker thread. Additional helper marker threads
+        may be configured to mark in parallel. Helpers share work via mark stacks and steal work from each other when 
+        idle. The number of helpers used for a collection adapts to the GC pause budget. The default is MPR_GC_WORKERS.
+    @param count Number of helper marker threads. Set to zero to mark using only the marker thread.
+    @ingroup MprMem
+  */
+extern void mprSetGCMarkers(int count);
+
+/**
+    Set the garbage collection pause time budget
+    @description The collector will try to keep the time all threads are paused for a collection within this budget
+        by engaging more parallel marker threads. Collections exceeding the budget are reported via mprPrintMem.
+    @param budget Pause time budget in milliseconds
+    @ingroup MprMem
+  */
+extern void mprSetGCPauseBudget(MprTime budget);
+
+/**
+    Control lazy sweeping
+    @description The collector runs block managers while all threads are paused, but may free dead blocks after the
+        threads resume. Regions not yet swept are swept by the marker thread in the background and on demand by threads
+        that would otherwise grow the heap. When disabled, all regions are swept in parallel before threads resume.
+        Lazy sweeping is enabled by default.
+    @param on Set to one to enable and zero to disable.
+    @ingroup MprMem
+  */
+extern void mprSetGCLazySweep(bool on);
+
+/**
+    Control generational collection
+    @description When enabled, blocks that survive a collection are promoted to an old generation. Most collections
+        are then minor collections that only trace blocks allocated since the prior collection. Old blocks that have
+        been modified since the prior collection are rescanned: blocks with managers have their managers run and blocks
+        without managers are scanned conservatively for references to young blocks. If a conservative reference to a
+        young block with a manager can't be resolved, the collection frees no young blocks and the next collection is
+        a full collection. Old blocks are only freed by a full collection which runs every MPR_GC_MINOR_CYCLES 
+        collections and when mprRequestGC is called with MPR_COMPLETE_GC, so managers of old blocks may not be invoked
+        with MPR_MANAGE_FREE until several collections after the blocks become unreferenced. Modified blocks are found using the O/S dirty page tracking where 
+        available. Otherwise all old blocks are treated as modified and minor collections do not save marking time.
+        Lazy sweeping is not used while generational collection is enabled. The nursery may also be enabled by setting 
+        the MPR_GC_NURSERY environment variable to "1".
+        \n\n
+        References to blocks must be stored in memory blocks or in blocks added via mprAddRoot. References held only in
+        static variables that are marked by the manager of another block may not be seen by a minor collection.
+    @param on Set to one to enable and zero to disable.
+    @return True if O/S dirty page tracking is available.
+    @ingroup MprMem
+  */
+extern bool mprSetGCNursery(bool on);
+
 /**
     Hold a memory block
     @description This call will protect a memory block from freeing by the garbage collector. Call mprRelease to
@@ -2684,6 +3040,107 @@ extern void mprWakeGCService();
 extern void mprResumeThreads();
 extern int  mprSyncThreads(MprTime timeout);
 
+/************************************ Arenas **********************************/
+/**
+    Arena memory allocator
+    @description Arenas bump-allocate short-lived memory such as request-scoped data. Arena memory is obtained from
+        the O/S via mprVirtAlloc and is not visited by the garbage collector sweeper. All arena blocks are released at
+        once by mprResetArena or when the arena itself is collected. The arena is an ordinary garbage collected
+        object that must be referenced (or made a root) to be retained. Arena blocks have standard memory headers, 
+        so they may be passed to mprMark and to routines that accept memory blocks. Blocks allocated with a manager 
+        are treated as part of the arena: their managers are invoked when the arena is marked, reset or freed.
+        Arenas are not thread-safe and should be used by one thread at a time.
+    @see mprArenaAlloc mprArenaAllocMem mprArenaAllocObj mprArenaClone mprArenaFmt mprArenaJoin mprCreateArena 
+        mprCreateArenaBuf mprResetArena 
+    @defgroup MprArena MprArena
+ */
+typedef struct MprArena {
+    struct MprArenaChunk *chunks;           /**< List of chunks. The first chunk is the current chunk */
+    char                 *next;             /**< Next free byte in the current chunk */
+    char                 *end;              /**< One past the end of the current chunk */
+    ssize                chunkSize;         /**< Default chunk size */
+    ssize                allocated;         /**< Bytes allocated since the arena was last reset */
+    int                  managed;           /**< Count of blocks with managers */
+    struct MprArena      *nextArena;        /**< Next live arena in the heap arena list */
+    struct MprArena      *prevArena;        /**< Previous live arena in the heap arena list */
+} MprArena;
+
+/**
+    Create an arena
+    @param chunkSize Size of memory chunks to obtain from the O/S. Set to zero for the default of MPR_ARENA_SIZE.
+    @return The arena object
+    @ingroup MprArena
+ */
+extern MprArena *mprCreateArena(ssize chunkSize);
+
+/**
+    Allocate a block from an arena
+    @description The block is released when the arena is reset or freed. The block will not be individually
+        collected by the garbage collector.
+    @param arena Arena created via mprCreateArena
+    @param size Size of the memory block to allocate
+    @param flags Allocation flags. Supported flags include: MPR_ALLOC_MANAGER to reserve room for a manager and
+        MPR_ALLOC_ZERO to zero the memory.
+    @return Returns a pointer to the allocated block. Returns null if memory is not available.
+    @ingroup MprArena
+ */
+extern void *mprArenaAllocMem(MprArena *arena, ssize size, int flags);
+
+/**
+    Release all blocks allocated from an arena
+    @description Any managers for arena blocks are invoked with MPR_MANAGE_FREE. All chunks but one are returned to
+        the O/S. All prior arena allocations become invalid.
+    @param arena Arena created via mprCreateArena
+    @ingroup MprArena
+ */
+extern void mprResetArena(MprArena *arena);
+
+/**
+    Clone a string into an arena
+    @param arena Arena created via mprCreateArena
+    @param str String to clone. If null, an empty string is allocated.
+    @return Returns a newly allocated string
+    @ingroup MprArena
+ */
+extern char *mprArenaClone(MprArena *arena, cchar *str);
+
+/**
+    Format a string into an arena
+    @description This is an arena version of sfmt.
+    @param arena Arena created via mprCreateArena
+    @param fmt Printf style format string
+    @param ... Variable arguments to format
+    @return Returns a newly allocated string
+    @ingroup MprArena
+ */
+extern char *mprArenaFmt(MprArena *arena, cchar *fmt, ...);
+
+/**
+    Format a string into an arena
+    @description This is an arena version of sfmtv.
+    @param arena Arena created via mprCreateArena
+    @param fmt Printf style format string
+    @param args Varargs argument obtained from va_start.
+    @return Returns a newly allocated string
+    @ingroup MprArena
+ */
+extern char *mprArenaFmtv(MprArena *arena, cchar *fmt, va_list args);
+
+/**
+    Join strings into an arena
+    @description This is an arena version of sjoin.
+    @param arena Arena created via mprCreateArena
+    @param str First string to join
+    @param ... Other strings to join. Terminate the list with NULL.
+    @return Returns a newly allocated string
+    @ingroup MprArena
+ */
+extern char *mprArenaJoin(MprArena *arena, cchar *str, ...);
+
+#define mprArenaAlloc(arena, size) mprArenaAllocMem(arena, size, 0)
+#define mprArenaAllocObj(arena, type, manage) \
+    ((type*) mprSetManager(mprArenaAllocMem(arena, sizeof(type), MPR_ALLOC_MANAGER | MPR_ALLOC_ZERO), (MprManager) manage))
+
 /********************************** Safe Strings ******************************/
 /**
     Safe String Module
@@ -3464,6 +3921,7 @@ typedef struct MprBuf {
     ssize           growBy;             /**< Next growth increment to use */
     MprBufProc      refillProc;         /**< Auto-refill procedure */
     void            *refillArg;         /**< Refill arg - must be alloced memory */
+    MprArena        *arena;             /**< Arena for buffer data. Null if allocated from the heap */
 } MprBuf;
 
 /**
@@ -3510,6 +3968,18 @@ extern void mprAdjustBufStart(MprBuf *buf, ssize count);
  */
 extern MprBuf *mprCreateBuf(ssize initialSize, ssize maxSize);
 
+/**
+    Create a new buffer with data allocated from an arena
+    @description The buffer object is allocated from the heap, but the buffer data is allocated from the arena. The
+        buffer data is released when the arena is reset, so the buffer must not be used after resetting the arena.
+    @param arena Arena created via mprCreateArena
+    @param initialSize Initial size of the buffer
+    @param maxSize Maximum size the buffer can grow to
+    @return a new buffer
+    @ingroup MprBuf
+ */
+extern MprBuf *mprCreateArenaBuf(MprArena *arena, ssize initialSize, ssize maxSize);
+
 /**
     Clone a buffer
     @description Copy the buffer and contents into a newly allocated buffer
@@ -3955,6 +4425,15 @@ extern char *mprGetDate(char *fmt);
  */
 extern uint64 mprGetTicks();
 
+/**
+    Get a high resolution time for measuring intervals
+    @description Get a monotonic time in microseconds. The time is not related to the calendar time. On systems 
+        without a monotonic clock, this returns the system time (msec resolution) scaled to microseconds.
+    @return Returns the time in microseconds.
+    @ingroup MprTime
+ */
+extern MprTime mprGetHiResTime();
+
 #if (LINUX || MACOSX || WINDOWS) && (BIT_CPU_ARCH == MPR_CPU_X86 || BIT_CPU_ARCH == MPR_CPU_X64)
     #define MPR_HIGH_RES_TIMER 1
 #else
@@ -6003,6 +6482,36 @@ extern int mprUnloadModule(MprModule *mp);
  */
 typedef void (*MprEventProc)(void *data, struct MprEvent *event);
 
+#define MPR_EVENT_STATS_BUCKETS 16      /**< Number of event latency histogram buckets */
+
+/**
+    Event statistics
+    @description Event statistics are collected per event loop and per dispatcher when enabled via 
+        #mprSetEventStats. Times are in microseconds. Histogram bucket N counts samples shorter than 2^N usec. 
+        The last bucket counts all longer samples. The I/O wait, wakeup and queue depth fields are only 
+        defined for event loops.
+    @ingroup MprEvent
+ */
+typedef struct MprEventStats {
+    uint64          events;                 /**< Count of events run */
+    uint64          batches;                /**< Count of dispatcher service passes that ran events */
+    int             maxBatch;               /**< Most events run in one service pass */
+    uint64          queueWait[MPR_EVENT_STATS_BUCKETS]; /**< Time from queueing (or due time) to running */
+    MprTime         totalQueueWait;         /**< Total queue wait time */
+    MprTime         maxQueueWait;           /**< Longest queue wait */
+    uint64          runTime[MPR_EVENT_STATS_BUCKETS];   /**< Event callback run time */
+    MprTime         totalRunTime;           /**< Total run time */
+    MprTime         maxRunTime;             /**< Longest run time */
+    uint64          ioWait[MPR_EVENT_STATS_BUCKETS];    /**< Time blocked waiting for I/O */
+    MprTime         totalIoWait;            /**< Total time blocked waiting for I/O */
+    uint64          waits;                  /**< Count of waits for I/O */
+    int             wakeups;                /**< Count of requests to wake the event loop */
+    int             readyDepth;             /**< Dispatchers on the readyQ when last sampled */
+    int             maxReadyDepth;          /**< Most dispatchers seen on the readyQ */
+    int             pendingDepth;           /**< Dispatchers on the pendingQ when last sampled */
+    int             maxPendingDepth;        /**< Most dispatchers seen on the pendingQ */
+} MprEventStats;
+
 /**
     Event object
     @description The MPR provides a powerful priority based eventing mechanism. Events are described by MprEvent objects
@@ -6031,6 +6540,8 @@ typedef struct MprEvent {
     struct MprEvent     *prev;          /**< Previous event linkage */
     struct MprDispatcher *dispatcher;   /**< Event dispatcher service */
     struct MprWaitHandler *handler;     /**< Optional wait handler */
+    struct MprEvent     *inboxNext;     /**< Dispatcher inbox linkage for posted events */
+    MprTime             queued;         /**< When queued (usec, see mprGetHiResTime). Only set if collecting stats */
 } MprEvent;
 
 /*
@@ -6051,8 +6562,20 @@ typedef struct MprDispatcher {
     struct MprEventService *service;
     struct MprWorker *requiredWorker;   /**< Worker affinity */
     MprOsThread     owner;              /**< Owning thread of the dispatcher */
+    MprTime         waitDue;            /**< Due time of the first event when queued on the waitHeap */
+    int             waitIndex;          /**< Index in the service waitHeap (origin 1). Zero if not waiting */
+    struct MprWorker *lastWorker;       /**< Worker that last serviced the dispatcher */
+    int             affinity;           /**< Prefer lastWorker when servicing */
+    MprEventStats   *stats;             /**< Event statistics. Allocated when first run with stats enabled */
+    MprEvent        *inbox;             /**< Lock-free stack of posted immediate events (newest first) */
+    struct MprDispatcher *inboxNext;    /**< Service inbox linkage. Non-null while listed on the service inbox */
 } MprDispatcher;
 
+/*
+    Terminates the service inbox list so that a listed dispatcher always has a non-null inboxNext
+ */
+#define MPR_INBOX_END ((MprDispatcher*) 1)
+
 
 typedef struct MprEventService {
     MprTime         now;                /**< Current notion of time for the dispatcher service */
@@ -6062,7 +6585,21 @@ typedef struct MprEventService {
     MprDispatcher   *waitQ;             /**< Queue of waiting (future) events */
     MprDispatcher   *idleQ;             /**< Queue of idle dispatchers */
     MprDispatcher   *pendingQ;          /**< Queue of pending dispatchers (waiting for resources) */
+    MprDispatcher   **waitHeap;         /**< Min-heap of waitQ dispatchers ordered by waitDue (origin 1) */
+    int             waitCount;          /**< Number of dispatchers in the waitHeap */
+    int             waitMax;            /**< Allocated size of the waitHeap */
+    int             waitOverflow;       /**< Some waitQ dispatchers are not in the waitHeap (memory depleted) */
+    MprDispatcher   *inbox;             /**< Lock-free stack of dispatchers with posted events */
     MprOsThread     serviceThread;      /**< Thread running the dispatcher service */
+    struct MprWaitService *waitService; /**< I/O notifier for this event loop */
+    struct MprEventService **loops;     /**< Fixed array of MPR_MAX_EVENT_LOOPS event loops. Only defined on the 
+                                             primary event service. Never reallocated so it can be read without locking */
+    int             loopCount;          /**< Number of event loops. Incremented after a new loop is stored in loops */
+    int             activeLoops;        /**< Number of event loops that new dispatchers are assigned to */
+    int             nextLoop;           /**< Next loop to assign a dispatcher (round-robin) */
+    int             index;              /**< Event loop index. Zero for the primary event service */
+    int             batch;              /**< Max events run per dispatcher batch. Zero for no limit */
+    MprEventStats   *stats;             /**< Event loop statistics. Null if not collecting stats */
     int             eventCount;         /**< Count of events */
     int             waiting;            /**< Waiting for I/O (sleeping) */
     struct MprCond  *waitCond;          /**< Waiting sync */
@@ -6077,6 +6614,18 @@ typedef struct MprEventService {
  */
 extern MprDispatcher *mprCreateDispatcher(cchar *name, int enable);
 
+/**
+    Create a new event dispatcher on a given event loop
+    @description Dispatchers are normally assigned to event loops round-robin. This creates a dispatcher whose I/O
+        and events are serviced by the specified loop.
+    @param name Useful name for debugging
+    @param loop Event loop index. Zero is the primary loop. The index is taken modulo the number of event loops.
+    @param enable If true, enable the dispatcher
+    @returns a Dispatcher object that can manage events and be used with mprCreateEvent
+    @ingroup MprEvent
+ */
+extern MprDispatcher *mprCreateLoopDispatcher(cchar *name, int loop, int enable);
+
 /**
     Destroy a dispatcher
     @param dispatcher Dispatcher to destroy
@@ -6113,6 +6662,83 @@ extern MprDispatcher *mprGetDispatcher();
  */
 extern int mprServiceEvents(MprTime delay, int flags);
 
+#define MPR_MAX_EVENT_LOOPS     64          /**< Maximum number of event loops */
+
+/**
+    Set the number of event loops
+    @description By default, one event service thread waits for all I/O and timer events. This call creates
+        additional event loops so I/O notification scales with the number of CPU cores. Each loop has its own I/O
+        notifier (epoll descriptor and wakeup pipe), dispatcher queues and service thread. On Linux, the service
+        thread of each additional loop is pinned to a CPU. Dispatchers are assigned to a loop when they are created,
+        round-robin over the loops. The primary dispatchers (mprGetDispatcher) always use the primary loop.
+        Loops are never destroyed. Reducing the count stops new dispatchers being assigned to the surplus loops, 
+        which continue to service their existing dispatchers. This may also be set via the MPR_EVENT_LOOPS 
+        environment variable. Additional loops are not supported on Windows.
+    @param count Total number of event loops including the primary loop.
+    @returns The number of event loops that new dispatchers are assigned to.
+    @ingroup MprEvent
+ */
+extern int mprSetEventLoops(int count);
+
+/**
+    Get the number of event loops
+    @returns The number of event loops that new dispatchers are assigned to, including the primary loop.
+    @ingroup MprEvent
+ */
+extern int mprGetEventLoops();
+
+/**
+    Set the event batch limit
+    @description A dispatcher runs its due events in a batch each time it is scheduled. This sets the maximum number 
+        of events run per batch. When the limit is reached, the dispatcher is rescheduled behind other ready 
+        dispatchers. This bounds how long one busy dispatcher can hold a worker.
+    @param count Maximum events per batch. Set to zero for no limit (the default).
+    @returns The previous limit.
+    @ingroup MprEvent
+ */
+extern int mprSetEventBatch(int count);
+
+/**
+    Set dispatcher worker affinity
+    @description If enabled, the dispatcher is serviced by the worker that last ran it. This keeps the state used by 
+        the dispatcher warm in the cache of one CPU. If that worker is busy and another worker is available, the other
+        worker is used. If that worker is still finishing the last pass of the dispatcher or the pool is saturated, 
+        the dispatcher is queued to run on it when its current work completes. Idle workers take over the queued work 
+        once it has waited longer than MPR_WORKER_PIN_WAIT. If the worker is exiting or its queue is full, any worker is used.
+    @param dispatcher Dispatcher to modify
+    @param enable Set to true to enable affinity
+    @ingroup MprEvent
+ */
+extern void mprSetDispatcherAffinity(MprDispatcher *dispatcher, bool enable);
+
+/**
+    Enable or disable event statistics
+    @description When enabled, each event loop and dispatcher records event counts and histograms of queue wait 
+        time, event run time and I/O wait time. Event loops also record wakeups and readyQ/pendingQ depths. 
+        When disabled, the cost is a test per event. This may also be enabled via the MPR_EVENT_STATS environment 
+        variable. Disabling discards the event loop statistics.
+    @param enable Set to true to collect statistics
+    @ingroup MprEvent
+ */
+extern void mprSetEventStats(bool enable);
+
+/**
+    Get the event statistics for a dispatcher
+    @param dispatcher Dispatcher to examine. Set to null for the statistics of the primary event loop.
+    @returns A reference to the statistics or null if statistics have not been collected. Do not modify its contents.
+    @ingroup MprEvent
+ */
+extern MprEventStats *mprGetEventStats(MprDispatcher *dispatcher);
+
+/**
+    Return the event statistics as an object tree
+    @description The object includes the statistics for each event loop and for each dispatcher that has run events 
+        while statistics were enabled. The object may be converted to JSON via #mprSerialize.
+    @returns An object tree of MprHash objects
+    @ingroup MprEvent
+ */
+extern struct MprHash *mprGetEventStatsObj();
+
 /**
     Wait for an event to occur on the given dispatcher
     @param dispatcher Event dispatcher to monitor
@@ -6131,7 +6757,8 @@ extern void mprSignalDispatcher(MprDispatcher *dispatcher);
 
 /**
     Create a new event
-    @description Create a new event for service
+    @description Create a new event for service. Immediate events (zero period and not continuous) are posted to a
+        lock-free dispatcher inbox and do not contend for the event service lock.
     @param dispatcher Dispatcher object created via mprCreateDispatcher
     @param name Debug name of the event
     @param period Time in milliseconds used by continuous events between firing of the event.
@@ -6243,6 +6870,7 @@ extern void mprClaimDispatcher(MprDispatcher *dispatcher);
 extern MprEventService *mprCreateEventService();
 extern void mprStopEventService();
 extern MprEvent *mprGetNextEvent(MprDispatcher *dispatcher);
+extern void mprServicePostedEvents(MprEventService *es);
 extern int mprGetEventCount(MprDispatcher *dispatcher);
 extern void mprInitEventQ(MprEvent *q);
 extern void mprScheduleDispatcher(MprDispatcher *dispatcher);
@@ -6451,7 +7079,8 @@ typedef struct MprJsonCallback {
 
 /**
     JSON parser
-    @see MprObj MprCheckState MprSetValue MprMakeObj mprSerialize mprDeserialize mprJsonParseError
+    @see MprObj MprCheckState MprSetValue MprMakeObj mprSerialize mprDeserialize mprJsonParseError mprSetJsonNumber 
+        mprSetJsonObj
     @defgroup MprJson MprJson
  */
 typedef struct MprJson {
@@ -6507,6 +7136,28 @@ extern MprObj *mprDeserialize(cchar *str);
  */
 extern void mprJsonParseError(MprJson *jp, cchar *fmt, ...);
 
+/**
+    Set a numeric property in a JSON object
+    @description Used to build JSON objects for serialization via #mprSerialize.
+    @param obj Object hash
+    @param key Property name
+    @param value Numeric value
+    @ingroup MprJson
+    @internal
+ */
+extern void mprSetJsonNumber(MprHash *obj, cchar *key, int64 value);
+
+/**
+    Set an object or array property in a JSON object
+    @param obj Object hash
+    @param key Property name
+    @param value Object or array hash
+    @param type Set to MPR_JSON_OBJ or MPR_JSON_ARRAY
+    @ingroup MprJson
+    @internal
+ */
+extern void mprSetJsonObj(MprHash *obj, cchar *key, MprHash *value, int type);
+
 /********************************* Threads ************************************/
 /**
     Thread service
@@ -6516,6 +7167,7 @@ typedef struct MprThreadService {
     MprList         *threads;           /**< List of all threads */
     struct MprThread *mainThread;       /**< Main application Mpr thread id */
     MprCond         *cond;              /**< Multi-thread sync */
+    struct MprThreadLocal *local;       /**< Thread local storage for the current MprThread */
     ssize           stackSize;          /**< Default thread stack size */
 } MprThreadService;
 
@@ -6565,6 +7217,10 @@ typedef struct MprThread {
 #endif
     int             stickyYield;        /**< Yielded does not auto-clear after GC */
     int             yielded;            /**< Thread has yielded to GC */
+    MprTime         yieldWait;          /**< Total time blocked in mprYield waiting for the GC (msec) */
+    uint64          yieldWaits;         /**< Count of times blocked in mprYield waiting for the GC */
+    MprMemCache     cache;              /**< Per-thread memory allocation cache */
+    MprMarkStack    *markStack;         /**< GC mark stack if this thread is a parallel marker */
 } MprThread;
 
 
@@ -6732,7 +7388,8 @@ typedef struct MprWaitService {
     int             eventsMax;              /* Max size of events/interest */
     struct MprWaitHandler **handlerMap;     /* Map of fds to handlers */
     int             handlerMax;             /* Size of the handlers array */
-    int             breakPipe[2];           /* Pipe to wakeup select */
+    int             breakPipe[2];           /* Eventfd or pipe to wakeup epoll. Both entries are the same eventfd */
+    struct MprUring *uring;                 /* io_uring state if using io_uring instead of epoll (MPR_IO_URING) */
 #elif MPR_EVENT_KQUEUE
     int             kq;                     /* Kqueue() return descriptor */
     struct kevent   *interest;              /* Events of interest */
@@ -6786,6 +7443,7 @@ extern int  mprStartWaitService(MprWaitService *ws);
 extern int  mprStopWaitService(MprWaitService *ws);
 extern void mprSetWaitServiceThread(MprWaitService *ws, MprThread *thread);
 extern void mprWakeNotifier();
+extern void mprWakeWaitService(MprWaitService *ws);
 extern int  mprInitWindow();
 #if MPR_EVENT_KQUEUE
     extern void mprManageKqueue(MprWaitService *ws, int flags);
@@ -6980,6 +7638,9 @@ typedef struct MprSocketService {
     MprHash         *providers;                 /**< Secure socket providers */         
     MprSocketPrebind prebind;                   /**< Prebind callback */
     MprList         *secureSockets;             /**< List of secured (matrixssl) sockets */
+    MprHash         *dnsCache;                  /**< Cache of resolved addresses for mprGetSocketInfo */
+    int             dnsCacheMax;                /**< Maximum number of cached addresses. Zero to disable */
+    MprTime         dnsCacheTtl;                /**< Lifespan of cached addresses in milliseconds */
     MprMutex        *mutex;                     /**< Multithread locking */
 } MprSocketService;
 
@@ -7038,6 +7699,12 @@ extern void mprAddSocketProvider(cchar *name, MprSocketProvider *provider);
 #define MPR_SOCKET_CLIENT       0x800       /**< Socket is a client */
 #define MPR_SOCKET_PENDING      0x1000      /**< Pending buffered read data */
 #define MPR_SOCKET_TRACED       0x2000      /**< Socket has been traced to the log */
+#define MPR_SOCKET_REUSEPORT    0x4000      /**< Open one SO_REUSEPORT listener per event loop */
+#define MPR_SOCKET_OWNED        0x8000      /**< Socket I/O is only done by the owning dispatcher. Skip I/O locking */
+
+#define MPR_SOCKET_MESSAGES     64          /**< Maximum datagrams per mprReadSocketMessages or mprWriteSocketMessages */
+#define MPR_DNS_CACHE_MAX       256         /**< Default maximum number of cached address lookups */
+#define MPR_DNS_CACHE_TTL       (60 * 1000) /**< Default lifespan of cached address lookups (msec) */
 
 /**
     Socket Service
@@ -7052,10 +7719,11 @@ extern void mprAddSocketProvider(cchar *name, MprSocketProvider *provider);
         mprCloseSocket mprConnectSocket mprCreateSocket mprCreateSocketService mprCreateSsl mprCloneSsl
         mprDisconnectSocket mprEnableSocketEvents mprFlushSocket mprGetSocketBlockingMode mprGetSocketError 
         mprGetSocketFd mprGetSocketInfo mprGetSocketPort mprHasSecureSockets mprIsSocketEof mprIsSocketSecure 
-        mprListenOnSocket mprLoadSsl mprParseIp mprReadSocket mprSendFileToSocket mprSetSecureProvider 
+        mprListenOnSocket mprLoadSsl mprParseIp mprReadSocket mprReadSocketMessages mprReadSocketVector 
+        mprSendFileToSocket mprSetSecureProvider 
         mprSetSocketBlockingMode mprSetSocketCallback mprSetSocketEof mprSetSocketNoDelay mprSetSslCaFile 
         mprSetSslCaPath mprSetSslCertFile mprSetSslCiphers mprSetSslKeyFile mprSetSslSslProtocols 
-        mprSetSslVerifySslClients mprWriteSocket mprWriteSocketString mprWriteSocketVector 
+        mprSetSslVerifySslClients mprWriteSocket mprWriteSocketMessages mprWriteSocketString mprWriteSocketVector 
         mprSocketHasPendingData mprUpgradeSocket
     @defgroup MprSocket MprSocket
  */
@@ -7076,6 +7744,13 @@ typedef struct MprSocket {
     void            *sslSocket;         /**< Extended SSL socket state */
     struct MprSsl   *ssl;               /**< SSL configuration */
     MprMutex        *mutex;             /**< Multi-thread sync */
+    MprList         *shards;            /**< Additional SO_REUSEPORT listeners, one per extra event loop */
+    int             relay[2];           /**< Pipe to splice socket sources via mprSendFileToSocket (Linux only) */
+    ssize           relayed;            /**< Bytes held in the relay pipe and not yet sent */
+    struct MprFile  *relayFile;         /**< File the relayed bytes were read from */
+    struct sockaddr *addr;              /**< Resolved datagram destination address for ip and port */
+    MprSocklen      addrlen;            /**< Length of addr */
+    MprTime         addrExpires;        /**< When addr must be resolved again */
 } MprSocket;
 
 
@@ -7096,6 +7771,19 @@ typedef struct MprIOVec {
  */
 MprSocket *mprAcceptSocket(MprSocket *listen);
 
+/**
+    Accept a batch of incoming connections
+    @description Accept pending connections until the listen backlog is drained or the batch is full. Use this from 
+        a listening socket I/O handler to service a burst of connections with one wakeup. The listening socket should 
+        be in non-blocking mode.
+    @param listen Listening server socket
+    @param sockets Array to receive the new socket connections
+    @param max Size of the sockets array
+    @returns The number of connections accepted
+    @ingroup MprSocket
+ */
+extern int mprAcceptSockets(MprSocket *listen, MprSocket **sockets, int max);
+
 /**
     Add a wait handler to a socket.
     @description Create a wait handler that will be invoked when I/O of interest occurs on the specified socket.
@@ -7105,7 +7793,9 @@ MprSocket *mprAcceptSocket(MprSocket *listen);
     @param dispatcher Dispatcher object to use for scheduling the I/O event.
     @param proc Callback function to invoke when an I/O event of interest has occurred.
     @param data Data item to pass to the callback
-    @param flags Socket handler flags
+    @param flags Socket handler flags. Set to MPR_SOCKET_OWNED to mark the socket as owned by the dispatcher. 
+        The socket mutex is then not taken when reading or writing. Only use this if all socket I/O is done by 
+        the dispatcher callbacks.
     @returns A new wait handler registered with the MPR event mechanism
     @ingroup MprSocket
  */
@@ -7135,6 +7825,8 @@ extern void mprCloseSocket(MprSocket *sp, bool graceful);
         @li MPR_SOCKET_NOREUSE - Set NOREUSE flag on the socket
         @li MPR_SOCKET_NODELAY - Set NODELAY on the socket
         @li MPR_SOCKET_THREAD - Process callbacks on a separate thread.
+        @li MPR_SOCKET_OWNED - The socket is only used by one thread or dispatcher. Reads and writes skip the 
+            socket mutex.
     @return Zero if the connection is successful. Otherwise a negative MPR error code.
     @ingroup MprSocket
  */
@@ -7203,6 +7895,8 @@ extern int mprGetSocketFd(MprSocket *sp);
 
 /**
     Get the socket for an IP:Port address
+    @description Addresses are resolved via getaddrinfo where supported. Results are cached for a limited time.
+        See #mprSetDnsCache.
     @param ip IP address or hostname 
     @param port Port number 
     @param family Output parameter to contain the Internet protocol family
@@ -7214,6 +7908,17 @@ extern int mprGetSocketFd(MprSocket *sp);
   */
 extern int mprGetSocketInfo(cchar *ip, int port, int *family, int *protocol, struct sockaddr **addr, MprSocklen *addrlen);
 
+/**
+    Configure the address lookup cache
+    @description Address lookups made via #mprGetSocketInfo are cached so frequent connections and datagram sends to 
+        the same host do not repeat name resolution. When the cache is full, expired entries are removed. If none 
+        have expired, the cache is flushed.
+    @param max Maximum number of cached lookups. Set to zero to disable caching and flush the cache.
+    @param ttl Lifespan of a cached lookup in milliseconds.
+    @ingroup MprSocket
+ */
+extern void mprSetDnsCache(int max, MprTime ttl);
+
 /**
     Get the port used by a socket
     @description Get the TCP/IP port number used by the socket.
@@ -7271,6 +7976,12 @@ extern bool mprIsSocketEof(MprSocket *sp);
         @li MPR_SOCKET_NOREUSE - Set NOREUSE flag on the socket
         @li MPR_SOCKET_NODELAY - Set NODELAY on the socket
         @li MPR_SOCKET_THREAD - Process callbacks on a separate thread.
+        @li MPR_SOCKET_REUSEPORT - Open one SO_REUSEPORT listener per event loop so the kernel spreads incoming 
+            connections over the loops. Handlers added via #mprAddSocketHandler are added to every listener, each on 
+            a dispatcher serviced by its own loop. #mprAcceptSocket called from a listener's handler accepts only from 
+            that listener. Requires non-blocking I/O. Ignored if SO_REUSEPORT is not supported.
+        @li MPR_SOCKET_OWNED - Accepted sockets are only used by their owning dispatcher. Reads and writes on the 
+            accepted sockets skip the socket mutex.
     @return Zero if the connection is successful. Otherwise a negative MPR error code.
     @ingroup MprSocket
  */
@@ -7303,6 +8014,34 @@ extern int mprParseSocketAddress(cchar *ipSpec, char **ip, int *port, int defaul
  */
 extern ssize mprReadSocket(MprSocket *sp, void *buf, ssize size);
 
+/**
+    Read a batch of datagrams
+    @description Receive up to count datagrams with one system call where supported (recvmmsg on Linux). Each 
+        datagram is received into one buffer. If the socket is in blocking mode, this blocks only until the first 
+        datagram is available.
+    @param sp Datagram socket object returned from #mprCreateSocket
+    @param msgs Vector of buffers to receive the datagrams. On return, the length of each received message is 
+        updated with the datagram size.
+    @param count Count of entries in msgs. At most MPR_SOCKET_MESSAGES datagrams are received per call.
+    @return The number of datagrams received. Zero if none are available. Returns MPR_ERR_CANT_READ on errors.
+    @ingroup MprSocket
+ */
+extern int mprReadSocketMessages(MprSocket *sp, MprIOVec *msgs, int count);
+
+/**
+    Read from a socket into a vector of buffers
+    @description Do scatter I/O by reading into a vector of buffers with one system call where supported (readv).
+        The buffers are filled in order. To read into a chain of MprBufs, set each vector entry to the buffer end 
+        (mprGetBufEnd) and free space (mprGetBufSpace), then adjust each buffer end by the data received 
+        (mprAdjustBufEnd).
+    @param sp Socket object returned from #mprCreateSocket
+    @param iovec Vector of buffers to receive the data
+    @param count Count of entries in iovec
+    @return A count of bytes actually read. Return -1 for EOF and a negative MPR error code on errors.
+    @ingroup MprSocket
+ */
+extern ssize mprReadSocketVector(MprSocket *sp, MprIOVec *iovec, int count);
+
 /**
     Remove a socket wait handler.
     @description Removes the socket wait handler created via mprAddSocketHandler.
@@ -7317,6 +8056,9 @@ extern void mprRemoveSocketHandler(MprSocket *sp);
     @description Write the contents of a file to a socket. If the socket is in non-blocking mode (the default), the write
         may return having written less than the required bytes. This API permits the writing of data before and after
         the file contents. 
+        On Linux, the file data is sent via sendfile. If the file is a pipe or socket (see mprAttachFileFd), the data 
+        is spliced to the socket and the offset is ignored. Headers and trailers are coalesced with the file data in 
+        as few packets as possible by corking the socket (TCP_CORK or MSG_MORE).
     @param file File to write to the socket
     @param sock Socket object returned from #mprCreateSocket
     @param offset offset within the file from which to read data
@@ -7417,6 +8159,20 @@ extern ssize mprWriteSocketString(MprSocket *sp, cchar *str);
  */
 extern ssize mprWriteSocketVector(MprSocket *sp, MprIOVec *iovec, int count);
 
+/**
+    Write a batch of datagrams
+    @description Send up to count datagrams to the socket address with one system call where supported (sendmmsg 
+        on Linux). Each buffer is sent as one datagram.
+    @param sp Datagram socket object returned from #mprCreateSocket and opened via #mprConnectSocket with 
+        MPR_SOCKET_DATAGRAM.
+    @param msgs Vector of buffers to send
+    @param count Count of entries in msgs. At most MPR_SOCKET_MESSAGES datagrams are sent per call.
+    @return The number of datagrams sent. Zero if the socket can't accept more data. Returns MPR_ERR_CANT_WRITE on 
+        errors.
+    @ingroup MprSocket
+ */
+extern int mprWriteSocketMessages(MprSocket *sp, MprIOVec *msgs, int count);
+
 /************************************ SSL *************************************/
 
 #define MPR_DEFAULT_SERVER_CERT_FILE    "server.crt"
@@ -7583,6 +8339,12 @@ typedef struct MprWorkerStats {
     int             maxUse;             /**< Max used */
     int             idleThreads;        /**< Current idle */
     int             busyThreads;        /**< Current busy */
+    int             queued;             /**< Tasks queued on worker task queues */
+    int             limit;              /**< Current pool size limit. Adapts between min and max if a target wait is set */
+    MprTime         targetWait;         /**< Target queue wait (usec) for adaptive sizing. Zero if not adaptive */
+    MprTime         lastWait;           /**< Longest queue wait seen in the last adaptive interval (usec) */
+    int             grows;              /**< Count of adaptive limit increases */
+    int             shrinks;            /**< Count of adaptive limit decreases */
 } MprWorkerStats;
 
 /**
@@ -7603,6 +8365,14 @@ typedef struct MprWorkerService {
     MprMutex        *mutex;             /**< Per task synchronization */
     struct MprEvent *pruneTimer;        /**< Timer for excess threads pruner */
     MprWorkerProc   startWorker;        /**< Worker thread startup hook */
+    int             queued;             /**< Tasks queued on worker task queues when all workers are busy */
+    int             limit;              /**< Current pool size limit (between minThreads and maxThreads) */
+    MprTime         targetWait;         /**< Target queue wait (usec) for adaptive sizing. Zero if not adaptive */
+    MprTime         waitSample;         /**< Longest queue wait in the current adaptive interval (usec) */
+    MprTime         lastWait;           /**< Longest queue wait in the last adaptive interval (usec) */
+    int             grows;              /**< Count of adaptive limit increases */
+    int             shrinks;            /**< Count of adaptive limit decreases */
+    struct MprEvent *adaptTimer;        /**< Timer for adaptive sizing */
 } MprWorkerService;
 
 
@@ -7646,6 +8416,19 @@ extern void mprSetMinWorkers(int count);
  */
 extern void mprSetMaxWorkers(int count);
 
+/**
+    Set a target queue wait for adaptive worker pool sizing
+    @description If all workers are busy, tasks are queued until a worker is free. When a target wait is set, the 
+        pool size limit adapts between the minimum and maximum worker counts. Each interval, if the longest queue 
+        wait exceeds the target, the limit is raised and workers are started for the queued tasks. If the wait is 
+        well under the target and workers are idle, the limit is lowered and an idle worker is pruned. 
+        This may also be set via the MPR_WORKER_TARGET_WAIT environment variable.
+    @param usec Target queue wait in microseconds. Set to zero to disable adaptive sizing. Then the limit is the 
+        maximum worker count.
+    @ingroup MprWorker
+ */
+extern void mprSetWorkerTargetWait(MprTime usec);
+
 /**
     Get the maximum count of worker pool threads
     Get the maximum limit of worker pool threads. 
@@ -7676,6 +8459,19 @@ extern void mprGetWorkerServiceStats(MprWorkerService *ws, MprWorkerStats *stats
         mprGetMaxWorkers mprGetWorkerServiceStats mprReleaseWorker mprSetMaxWorkers mprSetMinWorkers 
         mprSetWorkerStackSize mprStartWorker 
  */
+#define MPR_WORKER_TASKS 32                 /**< Max tasks queued on each worker when all workers are busy */
+#define MPR_WORKER_PIN_WAIT 10000           /**< Usec a pinned task waits for its worker before it may be stolen */
+
+/*
+    Queued worker task
+ */
+typedef struct MprWorkerTask {
+    MprWorkerProc   proc;                   /**< Procedure to run */
+    void            *data;                  /**< Argument for proc */
+    MprTime         queued;                 /**< When queued (usec, see mprGetHiResTime) */
+    int             pinned;                 /**< Queued for worker affinity. Not stolen until MPR_WORKER_PIN_WAIT */
+} MprWorkerTask;
+
 typedef struct MprWorker {
     MprWorkerProc   proc;                   /**< Procedure to run */
     MprWorkerProc   cleanup;                /**< Procedure to cleanup after run before sleeping */
@@ -7686,10 +8482,21 @@ typedef struct MprWorker {
     MprTime         lastActivity;           /**< When the worker was last used */
     MprWorkerService *workerService;        /**< Worker service */
     MprCond         *idleCond;              /**< Used to wait for work */
+    MprWorkerTask   tasks[MPR_WORKER_TASKS];/**< Queue of tasks (ring) */
+    int             taskHead;               /**< Oldest queued task. The owner and other workers take from here */
+    int             taskTail;               /**< After the newest queued task */
+    MprSpin         taskLock;               /**< Task queue lock */
 } MprWorker;
 
 extern void mprActivateWorker(MprWorker *worker, MprWorkerProc proc, void *data);
 
+/*
+    Run a task on a specific worker. If the worker is busy, the task is queued on the worker. 
+    Returns MPR_ERR_BUSY if the worker is exiting or its task queue is full.
+    @internal
+ */
+extern int mprStartWorkerOn(MprWorker *worker, MprWorkerProc proc, void *data);
+
 /**
     Dedicate a worker thread to a current real thread. This implements thread affinity and is required on some platforms
         where some APIs (waitpid on uClibc) cannot be called on a different thread.
@@ -7713,7 +8520,9 @@ extern void mprReleaseWorker(MprWorker *worker);
 
 /**
     Start a worker thread
-    @description Start a worker thread executing the given worker procedure callback.
+    @description Start a worker thread executing the given worker procedure callback. If all workers are busy
+        and the pool is at its maximum size, the task is queued on a busy worker. Queued tasks are run by that worker 
+        or stolen by the first worker to become free.
     @param proc Worker procedure callback
     @param data Data parameter to the callback
     @returns Zero if successful, otherwise a negative MPR error code.
@@ -7912,6 +8721,16 @@ extern void mprServiceSignals();
  */
 extern void mprAddStandardSignals();
 
+/**
+    Dump the allocation profile when a signal is received. 
+    @description The profile is written by #mprDumpMemProfile to the given path each time the signal is received.
+        The profiler must be started via #mprStartMemProfile.
+    @param signo Signal number to trap. Typically SIGPROF or SIGUSR2.
+    @param path Filename for the profile.
+    @return Zero if successful, otherwise a negative MPR error code.
+ */
+extern int mprAddMemProfileSignal(int signo, cchar *path);
+
 #define MPR_SIGNAL_BEFORE   0x1             /**< Flag to mprAddSignalHandler to run handler before existing handlers */
 #define MPR_SIGNAL_AFTER    0x2             /**< Flag to mprAddSignalHandler to run handler after existing handlers */
 
@@ -36,11 +36,31 @@ MprBuf *mprCreateBuf(ssize initialSize, ssize maxSize)
 }
 
 
+MprBuf *mprCreateArenaBuf(MprArena *arena, ssize initialSize, ssize maxSize)
+{
+    MprBuf      *bp;
+    
+    mprAssert(arena);
+
+    if (initialSize <= 0) {
+        initialSize = MPR_BUFSIZE;
+    }
+    if ((bp = mprAllocObj(MprBuf, manageBuf)) == 0) {
+        return 0;
+    }
+    bp->arena = arena;
+    bp->growBy = MPR_BUFSIZE;
+    mprSetBufSize(bp, initialSize, maxSize);
+    return bp;
+}
+
+
 static void manageBuf(MprBuf *bp, int flags)
 {
     if (flags & MPR_MANAGE_MARK) {
         mprMark(bp->data);
         mprMark(bp->refillArg);
+        mprMark(bp->arena);
     } 
 }
 
@@ -98,7 +118,8 @@ int mprSetBufSize(MprBuf *bp, ssize initialSize, ssize maxSize)
         bp->maxsize = maxSize;
         return 0;
     }
-    if ((bp->data = mprAlloc(initialSize)) == 0) {
+    bp->data = bp->arena ? mprArenaAlloc(bp->arena, initialSize) : mprAlloc(initialSize);
+    if (bp->data == 0) {
         mprAssert(!MPR_ERR_MEMORY);
         return MPR_ERR_MEMORY;
     }
@@ -429,7 +450,12 @@ int mprGrowBuf(MprBuf *bp, ssize need)
     } else {
         growBy = bp->growBy;
     }
-    if ((newbuf = mprAlloc(bp->buflen + growBy)) == 0) {
+    if (bp->arena) {
+        newbuf = mprArenaAlloc(bp->arena, bp->buflen + growBy);
+    } else {
+        newbuf = mprAlloc(bp->buflen + growBy);
+    }
+    if (newbuf == 0) {
         mprAssert(!MPR_ERR_MEMORY);
         return MPR_ERR_MEMORY;
     }
@@ -12,19 +12,36 @@
 
 /***************************** Forward Declarations ***************************/
 
+static MprEventService *createEventLoop(int index);
+static MprDispatcher *createDispatcher(MprEventService *es, cchar *name, int enable);
 static void dequeueDispatcher(MprDispatcher *dispatcher);
 static int dispatchEvents(MprDispatcher *dispatcher);
 static MprTime getDispatcherIdleTime(MprDispatcher *dispatcher, MprTime timeout);
 static MprTime getIdleTime(MprEventService *es, MprTime timeout);
 static MprDispatcher *getNextReadyDispatcher(MprEventService *es);
+static MprDispatcher *getWaitingDispatcher(MprEventService *es);
+static MprEventService *getLoop(int index);
+static MprEventService *getNextLoop();
 static void initDispatcher(MprDispatcher *q);
 static int makeRunnable(MprDispatcher *dispatcher);
 static void manageDispatcher(MprDispatcher *dispatcher, int flags);
 static void manageEventService(MprEventService *es, int flags);
 static void queueDispatcher(MprDispatcher *prior, MprDispatcher *dispatcher);
 static void scheduleDispatcher(MprDispatcher *dispatcher);
-static void serviceDispatcherMain(MprDispatcher *dispatcher);
+static void serviceDispatcherMain(MprDispatcher *dispatcher, MprWorker *worker);
 static bool serviceDispatcher(MprDispatcher *dp);
+static int serviceLoop(MprEventService *es, MprTime timeout, int flags);
+static void serviceLoopThread(MprEventService *es, MprThread *tp);
+static int pushWait(MprEventService *es, MprDispatcher *dispatcher);
+static MprDispatcher *scanWaiting(MprEventService *es, MprDispatcher *best);
+static void removeWait(MprEventService *es, MprDispatcher *dispatcher);
+static void siftWait(MprEventService *es, int index);
+static void wakeLoop(MprEventService *es);
+static void addSample(uint64 *histogram, MprTime value);
+static void recordBatch(MprDispatcher *dispatcher, int count);
+static void recordEvent(MprDispatcher *dispatcher, MprTime wait, MprTime run);
+static void recordWait(MprEventService *es, MprTime wait);
+static void sampleQueues(MprEventService *es);
 
 #define isRunning(dispatcher) (dispatcher->parent == dispatcher->service->runQ)
 #define isReady(dispatcher) (dispatcher->parent == dispatcher->service->readyQ)
@@ -39,32 +56,66 @@ MprEventService *mprCreateEventService()
 {
     MprEventService     *es;
 
-    if ((es = mprAllocObj(MprEventService, manageEventService)) == 0) {
+    if ((es = createEventLoop(0)) == 0) {
         return 0;
     }
     MPR->eventService = es;
+    return es;
+}
+
+
+/*
+    Create an event loop with its own dispatcher queues. The caller must define the wait service.
+ */
+static MprEventService *createEventLoop(int index)
+{
+    MprEventService     *es;
+
+    if ((es = mprAllocObj(MprEventService, manageEventService)) == 0) {
+        return 0;
+    }
+    es->index = index;
     es->now = mprGetTime();
     es->mutex = mprCreateLock();
     es->waitCond = mprCreateCond();
-    es->runQ = mprCreateDispatcher("running", 0);
-    es->readyQ = mprCreateDispatcher("ready", 0);
-    es->idleQ = mprCreateDispatcher("idle", 0);
-    es->pendingQ = mprCreateDispatcher("pending", 0);
-    es->waitQ = mprCreateDispatcher("waiting", 0);
+    es->runQ = createDispatcher(es, "running", 0);
+    es->readyQ = createDispatcher(es, "ready", 0);
+    es->idleQ = createDispatcher(es, "idle", 0);
+    es->pendingQ = createDispatcher(es, "pending", 0);
+    es->waitQ = createDispatcher(es, "waiting", 0);
+    es->waitMax = MPR_LIST_INCR;
+    es->waitHeap = mprAlloc((es->waitMax + 1) * sizeof(MprDispatcher*));
+    if (index > 0 && MPR->eventService->stats) {
+        es->stats = mprAllocZeroed(sizeof(MprEventStats));
+    }
     return es;
 }
 
 
 static void manageEventService(MprEventService *es, int flags)
 {
+    MprDispatcher   *dp;
+    int             i;
+
     if (flags & MPR_MANAGE_MARK) {
         mprMark(es->runQ);
         mprMark(es->readyQ);
         mprMark(es->waitQ);
         mprMark(es->idleQ);
         mprMark(es->pendingQ);
+        /* Dispatchers on the waitHeap are weak references. They remove themselves when destroyed */
+        mprMark(es->waitHeap);
         mprMark(es->waitCond);
         mprMark(es->mutex);
+        mprMark(es->waitService);
+        mprMark(es->loops);
+        for (i = 0; i < es->loopCount; i++) {
+            mprMark(es->loops[i]);
+        }
+        mprMark(es->stats);
+        for (dp = es->inbox; dp && dp != MPR_INBOX_END; dp = dp->inboxNext) {
+            mprMark(dp);
+        }
 
     } else if (flags & MPR_MANAGE_FREE) {
         /* Needed for race with manageDispatcher */
@@ -80,12 +131,374 @@ void mprStopEventService()
 }
 
 
+int mprSetEventLoops(int count)
+{
+    MprEventService     *es, *loop, **loops;
+    MprThread           *tp;
+
+    es = MPR->eventService;
+#if MPR_EVENT_ASYNC
+    count = 1;
+#endif
+    count = max(1, min(count, MPR_MAX_EVENT_LOOPS));
+    lock(es);
+    if (es->loops == 0) {
+        if (count == 1 || (loops = mprAllocZeroed(MPR_MAX_EVENT_LOOPS * sizeof(MprEventService*))) == 0) {
+            unlock(es);
+            return 1;
+        }
+        loops[0] = es;
+        es->loopCount = 1;
+        es->activeLoops = 1;
+        mprAtomicBarrier();
+        es->loops = loops;
+    }
+    /*
+        Loops are published with a barrier so mprWakeNotifier can walk the array without locking
+     */
+    while (es->loopCount < count) {
+        if ((loop = createEventLoop(es->loopCount)) == 0) {
+            break;
+        }
+        if ((loop->waitService = mprCreateWaitService()) == 0) {
+            break;
+        }
+        if ((tp = mprCreateThread(sfmt("events.%d", loop->index), serviceLoopThread, loop, 0)) == 0) {
+            break;
+        }
+        es->loops[es->loopCount] = loop;
+        mprAtomicBarrier();
+        es->loopCount++;
+        mprStartThread(tp);
+    }
+    es->activeLoops = count = min(count, es->loopCount);
+    unlock(es);
+    mprLog(MPR_CONFIG, "Using %d event loops", count);
+    return count;
+}
+
+
+int mprGetEventLoops()
+{
+    MprEventService     *es;
+
+    es = MPR->eventService;
+    return es->loops ? es->activeLoops : 1;
+}
+
+
+int mprSetEventBatch(int count)
+{
+    MprEventService     *es;
+    int                 prior;
+
+    es = MPR->eventService;
+    prior = es->batch;
+    es->batch = max(count, 0);
+    return prior;
+}
+
+
+void mprSetDispatcherAffinity(MprDispatcher *dispatcher, bool enable)
+{
+    dispatcher->affinity = enable;
+}
+
+
+void mprSetEventStats(bool enable)
+{
+    MprEventService     *es;
+    int                 next;
+
+    for (next = 0; (es = getLoop(next)) != 0; next++) {
+        if (!enable) {
+            es->stats = 0;
+        } else if (es->stats == 0) {
+            es->stats = mprAllocZeroed(sizeof(MprEventStats));
+        }
+    }
+}
+
+
+MprEventStats *mprGetEventStats(MprDispatcher *dispatcher)
+{
+    if (dispatcher == 0) {
+        return MPR->eventService->stats;
+    }
+    return dispatcher->stats;
+}
+
+
+/*
+    Bucket N counts values shorter than 2^N usec
+ */
+static void addSample(uint64 *histogram, MprTime value)
+{
+    int     bucket;
+
+    for (bucket = 0; bucket < (MPR_EVENT_STATS_BUCKETS - 1) && value >= (((MprTime) 1) << bucket); bucket++) { }
+    histogram[bucket]++;
+}
+
+
+/*
+    Record an event run in the dispatcher and event loop statistics. Must be locked when called.
+ */
+static void recordEvent(MprDispatcher *dispatcher, MprTime wait, MprTime run)
+{
+    MprEventStats   *stats[2];
+    MprEventStats   *sp;
+    int             i;
+
+    stats[0] = dispatcher->service->stats;
+    stats[1] = dispatcher->stats;
+    for (i = 0; i < 2; i++) {
+        if ((sp = stats[i]) == 0) {
+            continue;
+        }
+        sp->events++;
+        addSample(sp->queueWait, wait);
+        sp->totalQueueWait += wait;
+        sp->maxQueueWait = max(sp->maxQueueWait, wait);
+        addSample(sp->runTime, run);
+        sp->totalRunTime += run;
+        sp->maxRunTime = max(sp->maxRunTime, run);
+    }
+}
+
+
+static void recordBatch(MprDispatcher *dispatcher, int count)
+{
+    MprEventStats   *stats[2];
+    MprEventStats   *sp;
+    int             i;
+
+    stats[0] = dispatcher->service->stats;
+    stats[1] = dispatcher->stats;
+    for (i = 0; i < 2; i++) {
+        if ((sp = stats[i]) != 0) {
+            sp->batches++;
+            sp->maxBatch = max(sp->maxBatch, count);
+        }
+    }
+}
+
+
+static void recordWait(MprEventService *es, MprTime wait)
+{
+    MprEventStats   *sp;
+
+    lock(es);
+    if ((sp = es->stats) != 0) {
+        sp->waits++;
+        addSample(sp->ioWait, wait);
+        sp->totalIoWait += wait;
+    }
+    unlock(es);
+}
+
+
+static void sampleQueues(MprEventService *es)
+{
+    MprEventStats   *sp;
+    MprDispatcher   *dp;
+    int             count;
+
+    lock(es);
+    if ((sp = es->stats) != 0) {
+        for (count = 0, dp = es->readyQ->next; dp != es->readyQ; dp = dp->next) {
+            count++;
+        }
+        sp->readyDepth = count;
+        sp->maxReadyDepth = max(sp->maxReadyDepth, count);
+        for (count = 0, dp = es->pendingQ->next; dp != es->pendingQ; dp = dp->next) {
+            count++;
+        }
+        sp->pendingDepth = count;
+        sp->maxPendingDepth = max(sp->maxPendingDepth, count);
+    }
+    unlock(es);
+}
+
+
+static void addHistogram(MprHash *obj, cchar *key, uint64 *histogram)
+{
+    MprHash     *list;
+    char        index[16];
+    int         i;
+
+    list = mprCreateHash(0, MPR_HASH_LIST);
+    for (i = 0; i < MPR_EVENT_STATS_BUCKETS; i++) {
+        itosbuf(index, sizeof(index), i, 10);
+        mprSetJsonNumber(list, index, histogram[i]);
+    }
+    mprSetJsonObj(obj, key, list, MPR_JSON_ARRAY);
+}
+
+
+static MprHash *getStatsObj(MprEventStats *sp, int loop)
+{
+    MprHash     *obj;
+
+    obj = mprCreateHash(0, 0);
+    mprSetJsonNumber(obj, "events", sp->events);
+    mprSetJsonNumber(obj, "batches", sp->batches);
+    mprSetJsonNumber(obj, "maxBatch", sp->maxBatch);
+    mprSetJsonNumber(obj, "totalQueueWait", sp->totalQueueWait);
+    mprSetJsonNumber(obj, "maxQueueWait", sp->maxQueueWait);
+    addHistogram(obj, "queueWait", sp->queueWait);
+    mprSetJsonNumber(obj, "totalRunTime", sp->totalRunTime);
+    mprSetJsonNumber(obj, "maxRunTime", sp->maxRunTime);
+    addHistogram(obj, "runTime", sp->runTime);
+    if (loop) {
+        mprSetJsonNumber(obj, "waits", sp->waits);
+        mprSetJsonNumber(obj, "totalIoWait", sp->totalIoWait);
+        addHistogram(obj, "ioWait", sp->ioWait);
+        mprSetJsonNumber(obj, "wakeups", sp->wakeups);
+        mprSetJsonNumber(obj, "readyDepth", sp->readyDepth);
+        mprSetJsonNumber(obj, "maxReadyDepth", sp->maxReadyDepth);
+        mprSetJsonNumber(obj, "pendingDepth", sp->pendingDepth);
+        mprSetJsonNumber(obj, "maxPendingDepth", sp->maxPendingDepth);
+    }
+    return obj;
+}
+
+
+MprHash *mprGetEventStatsObj()
+{
+    MprEventService     *es;
+    MprDispatcher       *queues[5], *q, *dp;
+    MprHash             *obj, *loops, *dispatchers, *item;
+    char                key[16];
+    int                 next, count, i;
+
+    obj = mprCreateHash(0, 0);
+    loops = mprCreateHash(0, MPR_HASH_LIST);
+    dispatchers = mprCreateHash(0, MPR_HASH_LIST);
+    for (count = 0, next = 0; (es = getLoop(next)) != 0; next++) {
+        lock(es);
+        if (es->stats) {
+            item = getStatsObj(es->stats, 1);
+            mprSetJsonNumber(item, "loop", es->index);
+            itosbuf(key, sizeof(key), next, 10);
+            mprSetJsonObj(loops, key, item, MPR_JSON_OBJ);
+        }
+        queues[0] = es->runQ;
+        queues[1] = es->readyQ;
+        queues[2] = es->waitQ;
+        queues[3] = es->idleQ;
+        queues[4] = es->pendingQ;
+        for (i = 0; i < 5; i++) {
+            q = queues[i];
+            for (dp = q->next; dp != q; dp = dp->next) {
+                if (dp->stats) {
+                    item = getStatsObj(dp->stats, 0);
+                    mprAddKey(item, "name", dp->name);
+                    mprSetJsonNumber(item, "loop", es->index);
+                    itosbuf(key, sizeof(key), count++, 10);
+                    mprSetJsonObj(dispatchers, key, item, MPR_JSON_OBJ);
+                }
+            }
+        }
+        unlock(es);
+    }
+    mprSetJsonObj(obj, "loops", loops, MPR_JSON_ARRAY);
+    mprSetJsonObj(obj, "dispatchers", dispatchers, MPR_JSON_ARRAY);
+    return obj;
+}
+
+
+/*
+    Service thread for an additional event loop. This runs until the MPR core is stopped.
+ */
+static void serviceLoopThread(MprEventService *es, MprThread *tp)
+{
+#if LINUX
+    cpu_set_t   cpus;
+    int         ncpu;
+
+    if ((ncpu = (int) sysconf(_SC_NPROCESSORS_ONLN)) > 1) {
+        CPU_ZERO(&cpus);
+        CPU_SET(es->index % ncpu, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+            mprLog(4, "Can't set CPU affinity for event loop %d", es->index);
+        }
+    }
+#endif
+    es->serviceThread = mprGetCurrentOsThread();
+    serviceLoop(es, -1, 0);
+}
+
+
+/*
+    Get an event loop by index. Returns null if the index is out of range.
+ */
+static MprEventService *getLoop(int index)
+{
+    MprEventService     *es;
+
+    es = MPR->eventService;
+    if (es->loops == 0) {
+        return (index == 0) ? es : 0;
+    }
+    return (index >= 0 && index < es->loopCount) ? es->loops[index] : 0;
+}
+
+
+/*
+    Wake the I/O notifier of an event loop
+ */
+static void wakeLoop(MprEventService *es)
+{
+    MprEventStats   *stats;
+
+    if ((stats = es->stats) != 0) {
+        mprAtomicAdd(&stats->wakeups, 1);
+    }
+    if (es->waitService) {
+        mprWakeWaitService(es->waitService);
+    } else {
+        mprWakeNotifier();
+    }
+}
+
+
+/*
+    Select the event loop for a new dispatcher. Loops are assigned round-robin.
+ */
+static MprEventService *getNextLoop()
+{
+    MprEventService     *es;
+    int                 index;
+
+    es = MPR->eventService;
+    if (es->loops == 0) {
+        return es;
+    }
+    lock(es);
+    index = es->nextLoop++ % es->activeLoops;
+    unlock(es);
+    return es->loops[index];
+}
+
+
 /*
     Create a disabled dispatcher. A dispatcher schedules events on a single dispatch queue.
  */
 MprDispatcher *mprCreateDispatcher(cchar *name, int enable)
 {
-    MprEventService     *es;
+    return createDispatcher(getNextLoop(), name, enable);
+}
+
+
+MprDispatcher *mprCreateLoopDispatcher(cchar *name, int loop, int enable)
+{
+    return createDispatcher(getLoop(abs(loop) % mprGetEventLoops()), name, enable);
+}
+
+
+static MprDispatcher *createDispatcher(MprEventService *es, cchar *name, int enable)
+{
     MprDispatcher       *dispatcher;
 
     if ((dispatcher = mprAllocObj(MprDispatcher, manageDispatcher)) == 0) {
@@ -95,7 +508,7 @@ MprDispatcher *mprCreateDispatcher(cchar *name, int enable)
     dispatcher->cond = mprCreateCond();
     dispatcher->enabled = enable;
     dispatcher->magic = MPR_DISPATCHER_MAGIC;
-    es = dispatcher->service = MPR->eventService;
+    dispatcher->service = es;
     dispatcher->eventQ = mprCreateEventQueue();
     if (enable) {
         queueDispatcher(es->idleQ, dispatcher);
@@ -113,9 +526,7 @@ void mprDestroyDispatcher(MprDispatcher *dispatcher)
 
     if (dispatcher && !dispatcher->destroyed) {
         es = dispatcher->service;
-        mprAssert(es == MPR->eventService);
         lock(es);
-        mprAssert(dispatcher->service == MPR->eventService);
         mprAssert(dispatcher->magic == MPR_DISPATCHER_MAGIC);
         dequeueDispatcher(dispatcher);
         mprAssert(dispatcher->parent == dispatcher);
@@ -151,6 +562,8 @@ static void manageDispatcher(MprDispatcher *dispatcher, int flags)
         mprMark(dispatcher->parent);
         mprMark(dispatcher->service);
         mprMark(dispatcher->requiredWorker);
+        mprMark(dispatcher->lastWorker);
+        mprMark(dispatcher->stats);
 
         lock(es);
         q = dispatcher->eventQ;
@@ -158,6 +571,9 @@ static void manageDispatcher(MprDispatcher *dispatcher, int flags)
             mprAssert(event->magic == MPR_EVENT_MAGIC);
             mprMark(event);
         }
+        for (event = dispatcher->inbox; event; event = event->inboxNext) {
+            mprMark(event);
+        }
         unlock(es);
         
     } else if (flags & MPR_MANAGE_FREE) {
@@ -192,7 +608,7 @@ void mprEnableDispatcher(MprDispatcher *dispatcher)
     }
     unlock(es);
     if (mustWake) {
-        mprWakeNotifier();
+        wakeLoop(es);
     }
 }
 
@@ -209,9 +625,7 @@ void mprEnableDispatcher(MprDispatcher *dispatcher)
 int mprServiceEvents(MprTime timeout, int flags)
 {
     MprEventService     *es;
-    MprDispatcher       *dp;
-    MprTime             expires, delay;
-    int                 beginEventCount, eventCount, justOne;
+    int                 count;
 
     if (MPR->eventing) {
         mprError("mprServiceEvents() called reentrantly");
@@ -220,6 +634,22 @@ int mprServiceEvents(MprTime timeout, int flags)
     MPR->eventing = 1;
     mprInitWindow();
     es = MPR->eventService;
+    count = serviceLoop(es, timeout, flags);
+    MPR->eventing = 0;
+    return count;
+}
+
+
+/*
+    Service the dispatchers and I/O of one event loop. Signals and idle shutdown are only handled by the primary loop.
+ */
+static int serviceLoop(MprEventService *es, MprTime timeout, int flags)
+{
+    MprDispatcher       *dp;
+    MprTime             expires, delay, start;
+    int                 beginEventCount, eventCount, justOne, primary;
+
+    primary = (es == MPR->eventService);
     beginEventCount = eventCount = es->eventCount;
 
     es->now = mprGetTime();
@@ -231,9 +661,13 @@ int mprServiceEvents(MprTime timeout, int flags)
 
     while (es->now < expires && !mprIsStoppingCore()) {
         eventCount = es->eventCount;
-        if (MPR->signalService->hasSignals) {
+        if (primary && MPR->signalService->hasSignals) {
             mprServiceSignals();
         }
+        mprServicePostedEvents(es);
+        if (es->stats) {
+            sampleQueues(es);
+        }
         while ((dp = getNextReadyDispatcher(es)) != NULL) {
             mprAssert(!dp->destroyed);
             mprAssert(dp->magic == MPR_DISPATCHER_MAGIC);
@@ -242,7 +676,6 @@ int mprServiceEvents(MprTime timeout, int flags)
                 continue;
             }
             if (justOne) {
-                MPR->eventing = 0;
                 return abs(es->eventCount - beginEventCount);
             }
         } 
@@ -254,12 +687,18 @@ int mprServiceEvents(MprTime timeout, int flags)
                 es->willAwake = es->now + delay;
                 unlock(es);
                 if (mprIsStopping()) {
-                    if (mprServicesAreIdle()) {
+                    if (primary && mprServicesAreIdle()) {
                         break;
                     }
                     delay = 10;
                 }
-                mprWaitForIO(MPR->waitService, delay);
+                if (es->stats) {
+                    start = mprGetHiResTime();
+                    mprWaitForIO(es->waitService, delay);
+                    recordWait(es, mprGetHiResTime() - start);
+                } else {
+                    mprWaitForIO(es->waitService, delay);
+                }
             } else {
                 unlock(es);
             }
@@ -269,7 +708,6 @@ int mprServiceEvents(MprTime timeout, int flags)
             break;
         }
     }
-    MPR->eventing = 0;
     return abs(es->eventCount - beginEventCount);
 }
 
@@ -286,15 +724,15 @@ int mprWaitForEvent(MprDispatcher *dispatcher, MprTime timeout)
     MprOsThread         thread;
     int                 claimed, signalled, wasRunning, runEvents;
 
+    if (dispatcher == NULL) {
+        dispatcher = MPR->dispatcher;
+    }
     mprAssert(dispatcher->magic == MPR_DISPATCHER_MAGIC);
     mprAssert(!dispatcher->destroyed);
 
-    es = MPR->eventService;
+    es = dispatcher->service;
     es->now = mprGetTime();
 
-    if (dispatcher == NULL) {
-        dispatcher = MPR->dispatcher;
-    }
     mprAssert(!dispatcher->waitingOnCond);
     if (dispatcher->waitingOnCond) {
         return MPR_ERR_BUSY;
@@ -328,8 +766,10 @@ int mprWaitForEvent(MprDispatcher *dispatcher, MprTime timeout)
             }
         }
         lock(es);
-        delay = getDispatcherIdleTime(dispatcher, expires - es->now);
+        /* Set waitingOnCond before testing the inbox so a racing postEvent will signal the cond */
         dispatcher->waitingOnCond = 1;
+        mprAtomicBarrier();
+        delay = getDispatcherIdleTime(dispatcher, expires - es->now);
         mprAssert(!dispatcher->destroyed);
         unlock(es);
         
@@ -369,16 +809,18 @@ void mprWakeDispatchers()
 {
     MprEventService     *es;
     MprDispatcher       *runQ, *dp;
+    int                 next;
 
-    es = MPR->eventService;
-    lock(es);
-    runQ = es->runQ;
-    for (dp = runQ->next; dp != runQ; dp = dp->next) {
-        mprAssert(dp->magic == MPR_DISPATCHER_MAGIC);
-        mprAssert(!dp->destroyed);
-        mprSignalCond(dp->cond);
+    for (next = 0; (es = getLoop(next)) != 0; next++) {
+        lock(es);
+        runQ = es->runQ;
+        for (dp = runQ->next; dp != runQ; dp = dp->next) {
+            mprAssert(dp->magic == MPR_DISPATCHER_MAGIC);
+            mprAssert(!dp->destroyed);
+            mprSignalCond(dp->cond);
+        }
+        unlock(es);
     }
-    unlock(es);
 }
 
 
@@ -386,18 +828,21 @@ int mprDispatchersAreIdle()
 {
     MprEventService     *es;
     MprDispatcher       *runQ, *dispatcher;
-    int                 idle;
+    int                 idle, next;
 
-    es = MPR->eventService;
-    runQ = es->runQ;
-    lock(es);
-    dispatcher = runQ->next;
-    if (dispatcher == runQ) {
-        idle = 1;
-    } else {
-        idle = (dispatcher->eventQ == dispatcher->eventQ->next);
+    idle = 1;
+    for (next = 0; idle && (es = getLoop(next)) != 0; next++) {
+        runQ = es->runQ;
+        lock(es);
+        dispatcher = runQ->next;
+        if (dispatcher != runQ) {
+            idle = (dispatcher->eventQ == dispatcher->eventQ->next);
+        }
+        if (es->inbox) {
+            idle = 0;
+        }
+        unlock(es);
     }
-    unlock(es);
     return idle;
 }
 
@@ -481,19 +926,21 @@ void mprScheduleDispatcher(MprDispatcher *dispatcher)
         mprSignalDispatcher(dispatcher);
     }
     if (mustWakeWaitService) {
-        mprWakeNotifier();
+        wakeLoop(es);
     }
 }
 
 
 /*
-    Dispatch events for a dispatcher
+    Dispatch due events for a dispatcher. Runs up to the event batch limit (see mprSetEventBatch). If events remain,
+    scheduleDispatcher puts the dispatcher back on the readyQ.
  */
 static int dispatchEvents(MprDispatcher *dispatcher)
 {
     MprEventService     *es;
     MprEvent            *event;
-    int                 count;
+    MprTime             start, wait;
+    int                 batch, count, stats;
 
     mprAssert(dispatcher->enabled);
     mprAssert(dispatcher->cond);
@@ -502,10 +949,25 @@ static int dispatchEvents(MprDispatcher *dispatcher)
     es = dispatcher->service;
     LOG(7, "dispatchEvents for %s", dispatcher->name);
 
+    batch = MPR->eventService->batch;
+    if ((stats = (es->stats != 0)) != 0 && dispatcher->stats == 0) {
+        dispatcher->stats = mprAllocZeroed(sizeof(MprEventStats));
+    }
+    start = wait = 0;
+
     lock(es);
-    for (count = 0; (event = mprGetNextEvent(dispatcher)) != 0; count++) {
+    for (count = 0; (batch == 0 || count < batch) && (event = mprGetNextEvent(dispatcher)) != 0; count++) {
         mprAssert(event->magic == MPR_EVENT_MAGIC);
         dispatcher->current = event;
+        if (stats) {
+            /* Immediate events wait from when they were queued. Timers wait from when they were due */
+            start = mprGetHiResTime();
+            if (event->period == 0 && event->queued) {
+                wait = start - event->queued;
+            } else {
+                wait = max(mprGetTime() - event->due, 0) * 1000;
+            }
+        }
         if (event->continuous) {
             /* Reschedule if continuous */
             event->timestamp = dispatcher->service->now;
@@ -518,11 +980,17 @@ static int dispatchEvents(MprDispatcher *dispatcher)
         (event->proc)(event->data, event);
         dispatcher->current = 0;
         lock(es);
+        if (stats) {
+            recordEvent(dispatcher, wait, mprGetHiResTime() - start);
+        }
+    }
+    if (stats && count) {
+        recordBatch(dispatcher, count);
     }
     unlock(es);
     if (count && es->waiting) {
         es->eventCount += count;
-        mprWakeNotifier();
+        wakeLoop(es);
     }
     return count;
 }
@@ -538,11 +1006,15 @@ static bool serviceDispatcher(MprDispatcher *dispatcher)
     dispatcher->owner = mprGetCurrentOsThread();
 
     if (dispatcher == MPR->nonBlock) {
-        serviceDispatcherMain(dispatcher);
+        serviceDispatcherMain(dispatcher, 0);
 
     } else if (dispatcher->requiredWorker) {
         mprActivateWorker(dispatcher->requiredWorker, (MprWorkerProc) serviceDispatcherMain, dispatcher);
 
+    } else if (dispatcher->affinity && dispatcher->lastWorker && 
+            mprStartWorkerOn(dispatcher->lastWorker, (MprWorkerProc) serviceDispatcherMain, dispatcher) == 0) {
+        /* Serviced by the same worker as last time */ ;
+
     } else if (mprStartWorker((MprWorkerProc) serviceDispatcherMain, dispatcher) < 0) {
         return 0;
     }
@@ -550,7 +1022,7 @@ static bool serviceDispatcher(MprDispatcher *dispatcher)
 }
 
 
-static void serviceDispatcherMain(MprDispatcher *dispatcher)
+static void serviceDispatcherMain(MprDispatcher *dispatcher, MprWorker *worker)
 {
     if (dispatcher->destroyed) {
         /* Dispatcher may have been destroyed after starting the worker */
@@ -563,6 +1035,9 @@ static void serviceDispatcherMain(MprDispatcher *dispatcher)
     mprAssert(!dispatcher->destroyed);
 
     dispatcher->owner = mprGetCurrentOsThread();
+    if (worker) {
+        dispatcher->lastWorker = worker;
+    }
     dispatchEvents(dispatcher);
     if (!dispatcher->destroyed) {
         dispatcher->owner = 0;
@@ -589,10 +1064,8 @@ void mprWakePendingDispatchers()
  */
 static MprDispatcher *getNextReadyDispatcher(MprEventService *es)
 {
-    MprDispatcher   *dp, *next, *pendingQ, *readyQ, *waitQ, *dispatcher;
-    MprEvent        *event;
+    MprDispatcher   *dp, *pendingQ, *readyQ, *dispatcher;
 
-    waitQ = es->waitQ;
     readyQ = es->readyQ;
     pendingQ = es->pendingQ;
     dispatcher = 0;
@@ -607,18 +1080,10 @@ static MprDispatcher *getNextReadyDispatcher(MprEventService *es)
 
     } else if (readyQ->next == readyQ) {
         /*
-            ReadyQ is empty, try to transfer a dispatcher with due events onto the readyQ
+            ReadyQ is empty, try to transfer the waiting dispatcher with the earliest due event onto the readyQ
          */
-        for (dp = waitQ->next; dp != waitQ; dp = next) {
-            mprAssert(dp->magic == MPR_DISPATCHER_MAGIC);
-            mprAssert(!dp->destroyed);
-            next = dp->next;
-            event = dp->eventQ->next;
-            mprAssert(event->magic == MPR_EVENT_MAGIC);
-            if (event->due <= es->now && dp->enabled) {
-                queueDispatcher(es->readyQ, dp);
-                break;
-            }
+        if ((dp = getWaitingDispatcher(es)) != 0 && dp->waitDue <= es->now) {
+            queueDispatcher(es->readyQ, dp);
         }
     }
     if (!dispatcher && readyQ->next != readyQ) {
@@ -642,33 +1107,19 @@ static MprDispatcher *getNextReadyDispatcher(MprEventService *es)
  */
 static MprTime getIdleTime(MprEventService *es, MprTime timeout)
 {
-    MprDispatcher   *readyQ, *waitQ, *dp;
-    MprEvent        *event;
+    MprDispatcher   *readyQ, *dp;
     MprTime         delay;
 
-    waitQ = es->waitQ;
     readyQ = es->readyQ;
 
-    if (readyQ->next != readyQ) {
+    if (readyQ->next != readyQ || es->inbox) {
         delay = 0;
     } else if (mprIsStopping()) {
         delay = 10;
     } else {
         delay = MPR_MAX_TIMEOUT;
-        /*
-            Examine all the dispatchers on the waitQ
-         */
-        for (dp = waitQ->next; dp != waitQ; dp = dp->next) {
-            mprAssert(dp->magic == MPR_DISPATCHER_MAGIC);
-            mprAssert(!dp->destroyed);
-            event = dp->eventQ->next;
-            mprAssert(event->magic == MPR_EVENT_MAGIC);
-            if (event != dp->eventQ) {
-                delay = min(delay, (event->due - es->now));
-                if (delay <= 0) {
-                    break;
-                }
-            }
+        if ((dp = getWaitingDispatcher(es)) != 0) {
+            delay = max(dp->waitDue - es->now, 0);
         }
         delay = min(delay, timeout);
     }
@@ -676,6 +1127,53 @@ static MprTime getIdleTime(MprEventService *es, MprTime timeout)
 }
 
 
+/*
+    Get the waiting dispatcher with the earliest due event from the top of the waitHeap. The heap is keyed on the due
+    time of each dispatcher's first event when it was queued. Events may be removed from a waiting dispatcher without
+    rescheduling it, so a stale key is refreshed here before it is trusted. If the waitHeap could not be grown, 
+    retry adding the overflow dispatchers and otherwise fall back to scanning the waitQ. Must be called locked.
+ */
+static MprDispatcher *getWaitingDispatcher(MprEventService *es)
+{
+    MprDispatcher   *dp, *next;
+    MprEvent        *event;
+
+    if (es->waitOverflow) {
+        for (dp = es->waitQ->next; dp != es->waitQ; dp = next) {
+            next = dp->next;
+            if (dp->waitIndex == 0 && !isEmpty(dp) && pushWait(es, dp) < 0) {
+                break;
+            }
+        }
+        if (dp == es->waitQ) {
+            es->waitOverflow = 0;
+        }
+    }
+    dp = 0;
+    while (es->waitCount > 0) {
+        dp = es->waitHeap[1];
+        mprAssert(dp->magic == MPR_DISPATCHER_MAGIC);
+        mprAssert(!dp->destroyed);
+        mprAssert(isWaiting(dp));
+        event = dp->eventQ->next;
+        if (event == dp->eventQ || !dp->enabled) {
+            queueDispatcher(es->idleQ, dp);
+            dp = 0;
+        } else if (event->due != dp->waitDue) {
+            dp->waitDue = event->due;
+            siftWait(es, 1);
+            dp = 0;
+        } else {
+            break;
+        }
+    }
+    if (es->waitOverflow) {
+        dp = scanWaiting(es, dp);
+    }
+    return dp;
+}
+
+
 static MprTime getDispatcherIdleTime(MprDispatcher *dispatcher, MprTime timeout)
 {
     MprEvent    *next;
@@ -683,7 +1181,7 @@ static MprTime getDispatcherIdleTime(MprDispatcher *dispatcher, MprTime timeout)
 
     mprAssert(dispatcher->magic == MPR_DISPATCHER_MAGIC);
 
-    if (timeout < 0) {
+    if (timeout < 0 || dispatcher->inbox) {
         timeout = 0;
     } else {
         next = dispatcher->eventQ->next;
@@ -713,7 +1211,6 @@ static void initDispatcher(MprDispatcher *q)
 
 static void queueDispatcher(MprDispatcher *prior, MprDispatcher *dispatcher)
 {
-    mprAssert(dispatcher->service == MPR->eventService);
     lock(dispatcher->service);
 
     mprAssert(dispatcher->magic == MPR_DISPATCHER_MAGIC);
@@ -727,6 +1224,9 @@ static void queueDispatcher(MprDispatcher *prior, MprDispatcher *dispatcher)
     dispatcher->next = prior->next;
     prior->next->prev = dispatcher;
     prior->next = dispatcher;
+    if (isWaiting(dispatcher) && !isEmpty(dispatcher)) {
+        pushWait(dispatcher->service, dispatcher);
+    }
     mprAssert(dispatcher->cond);
     unlock(dispatcher->service);
 }
@@ -737,12 +1237,14 @@ static void queueDispatcher(MprDispatcher *prior, MprDispatcher *dispatcher)
  */
 static void dequeueDispatcher(MprDispatcher *dispatcher)
 {
-    mprAssert(dispatcher->service == MPR->eventService);
     lock(dispatcher->service);
 
     mprAssert(dispatcher->magic == MPR_DISPATCHER_MAGIC);
     mprAssert(!dispatcher->destroyed);
            
+    if (dispatcher->waitIndex) {
+        removeWait(dispatcher->service, dispatcher);
+    }
     if (dispatcher->next) {
         dispatcher->next->prev = dispatcher->prev;
         dispatcher->prev->next = dispatcher->next;
@@ -759,11 +1261,121 @@ static void dequeueDispatcher(MprDispatcher *dispatcher)
 }
 
 
+/*
+    Add a dispatcher to the waitHeap keyed on the due time of its first event. The heap is grown before any state is 
+    changed. If it can't be grown, the dispatcher remains on the waitQ without a heap entry and the waitQ is scanned 
+    by getWaitingDispatcher() instead. Must be called locked.
+ */
+static int pushWait(MprEventService *es, MprDispatcher *dispatcher)
+{
+    MprDispatcher   **heap;
+    int             max;
+
+    mprAssert(dispatcher->waitIndex == 0);
+
+    if (es->waitCount >= es->waitMax) {
+        max = es->waitMax * 2;
+        if ((heap = mprRealloc(es->waitHeap, (max + 1) * sizeof(MprDispatcher*))) == 0) {
+            if (!es->waitOverflow) {
+                mprError("Can't grow the dispatcher wait heap, scanning the wait queue instead");
+            }
+            es->waitOverflow = 1;
+            return MPR_ERR_MEMORY;
+        }
+        es->waitHeap = heap;
+        es->waitMax = max;
+    }
+    dispatcher->waitDue = dispatcher->eventQ->next->due;
+    dispatcher->waitIndex = ++es->waitCount;
+    es->waitHeap[dispatcher->waitIndex] = dispatcher;
+    siftWait(es, dispatcher->waitIndex);
+    return 0;
+}
+
+
+/*
+    Find the waiting dispatcher with the earliest due event amongst those without a waitHeap entry. Used only when the 
+    waitHeap can't hold all waiting dispatchers. Returns the earlier of that dispatcher and best. Must be called locked.
+ */
+static MprDispatcher *scanWaiting(MprEventService *es, MprDispatcher *best)
+{
+    MprDispatcher   *dp;
+
+    for (dp = es->waitQ->next; dp != es->waitQ; dp = dp->next) {
+        if (dp->waitIndex || isEmpty(dp) || !dp->enabled) {
+            continue;
+        }
+        dp->waitDue = dp->eventQ->next->due;
+        if (best == 0 || dp->waitDue < best->waitDue) {
+            best = dp;
+        }
+    }
+    return best;
+}
+
+
+/*
+    Remove a dispatcher from the waitHeap by moving the last entry into its slot. Must be called locked.
+ */
+static void removeWait(MprEventService *es, MprDispatcher *dispatcher)
+{
+    MprDispatcher   *last;
+    int             index;
+
+    index = dispatcher->waitIndex;
+    mprAssert(index > 0 && index <= es->waitCount);
+    mprAssert(es->waitHeap[index] == dispatcher);
+
+    dispatcher->waitIndex = 0;
+    last = es->waitHeap[es->waitCount--];
+    if (last != dispatcher) {
+        es->waitHeap[index] = last;
+        last->waitIndex = index;
+        siftWait(es, index);
+    }
+}
+
+
+/*
+    Restore heap order for the entry at the given index by moving it up or down as required. Must be called locked.
+ */
+static void siftWait(MprEventService *es, int index)
+{
+    MprDispatcher   **heap, *dp;
+    int             parent, child;
+
+    heap = es->waitHeap;
+    dp = heap[index];
+
+    while (index > 1) {
+        parent = index / 2;
+        if (heap[parent]->waitDue <= dp->waitDue) {
+            break;
+        }
+        heap[index] = heap[parent];
+        heap[index]->waitIndex = index;
+        index = parent;
+    }
+    while ((child = index * 2) <= es->waitCount) {
+        if (child < es->waitCount && heap[child + 1]->waitDue < heap[child]->waitDue) {
+            child++;
+        }
+        if (dp->waitDue <= heap[child]->waitDue) {
+            break;
+        }
+        heap[index] = heap[child];
+        heap[index]->waitIndex = index;
+        index = child;
+    }
+    heap[index] = dp;
+    dp->waitIndex = index;
+}
+
+
 static void scheduleDispatcher(MprDispatcher *dispatcher)
 {
     MprEventService     *es;
 
-    mprAssert(dispatcher->service == MPR->eventService);
     es = dispatcher->service;
 
     lock(es);
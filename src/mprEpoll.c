@@ -4,6 +4,10 @@
     This module augments the mprWait wait services module by providing kqueue() based waiting support.
     Also see mprAsyncSelectWait and mprSelectWait. This module is thread-safe.
 
+    If built with BIT_HAS_IO_URING and the MPR_IO_URING environment variable is set to 1, readiness is instead
+    collected via io_uring one-shot poll requests. Registrations are batched in the submission ring and submitted 
+    with the same io_uring_enter call that waits for completions. If io_uring is not usable, epoll is used.
+
     Copyright (c) All Rights Reserved. See details at the end of the file.
  */
 
@@ -12,11 +16,58 @@
 #include    "mpr.h"
 
 #if MPR_EVENT_EPOLL
+
+#if BIT_HAS_IO_URING && defined(IORING_FEAT_EXT_ARG) && defined(__NR_io_uring_setup)
+    #define HAS_URING 1
+#else
+    #define HAS_URING 0
+#endif
+
+#if HAS_URING
+/*
+    Completion tags. Poll requests for handlers use ((seq << 32) | fd) where seq is a positive 31-bit sequence number.
+ */
+#define URING_WAKE      ((uint64) -1)           /* Poll on the wakeup eventfd */
+#define URING_IGNORE    ((uint64) -2)           /* Poll remove requests */
+
+/*
+    io_uring ring state. The rings are shared with the kernel via mmap.
+ */
+typedef struct MprUring {
+    int                 fd;                     /* io_uring descriptor */
+    uint                *sqHead;                /* Submission ring head (advanced by the kernel) */
+    uint                *sqTail;                /* Submission ring tail (advanced by the MPR) */
+    uint                *sqMask;
+    uint                *sqArray;
+    uint                *cqHead;                /* Completion ring head (advanced by the MPR) */
+    uint                *cqTail;                /* Completion ring tail (advanced by the kernel) */
+    uint                *cqMask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void                *sqRing;
+    void                *cqRing;
+    size_t              sqRingSize;
+    size_t              cqRingSize;
+    size_t              sqesSize;
+    uint                sqEntries;
+    int                 pending;                /* Prepared submissions not yet given to the kernel */
+    int                 seq;                    /* Registration sequence number */
+} MprUring;
+#endif
+
 /********************************** Forwards **********************************/
 
 static int growEvents(MprWaitService *ws);
+static int growHandlerMap(MprWaitService *ws, int fd);
 static void serviceIO(MprWaitService *ws, int count);
 
+#if HAS_URING
+static int createUring(MprWaitService *ws);
+static void uringWaitForIO(MprWaitService *ws, MprTime timeout);
+static int uringNotifyOn(MprWaitService *ws, MprWaitHandler *wp, int mask);
+static void uringPoll(MprWaitService *ws, int fd, int mask, uint64 tag);
+#endif
+
 /************************************ Code ************************************/
 
 int mprCreateNotifierService(MprWaitService *ws)
@@ -35,16 +86,32 @@ int mprCreateNotifierService(MprWaitService *ws)
         return MPR_ERR_CANT_INITIALIZE;
     }
     /*
-        Initialize the "wakeup" pipe. This is used to wakeup the service thread if other threads need 
-     *  to wait for I/O.
+        Initialize the "wakeup" descriptor. This is used to wakeup the service thread if other threads need 
+        to wait for I/O. An eventfd needs one descriptor and coalesces multiple wakeups into one counter.
+        Fall back to a pipe on kernels without eventfd.
      */
-    if (pipe(ws->breakPipe) < 0) {
-        mprError("Can't open breakout pipe");
-        return MPR_ERR_CANT_INITIALIZE;
+    if ((ws->breakPipe[0] = eventfd(0, EFD_NONBLOCK)) >= 0) {
+        ws->breakPipe[1] = ws->breakPipe[0];
+    } else {
+        if (pipe(ws->breakPipe) < 0) {
+            mprError("Can't open breakout pipe");
+            return MPR_ERR_CANT_INITIALIZE;
+        }
+        fcntl(ws->breakPipe[0], F_SETFL, fcntl(ws->breakPipe[0], F_GETFL) | O_NONBLOCK);
+        fcntl(ws->breakPipe[1], F_SETFL, fcntl(ws->breakPipe[1], F_GETFL) | O_NONBLOCK);
     }
-    fcntl(ws->breakPipe[0], F_SETFL, fcntl(ws->breakPipe[0], F_GETFL) | O_NONBLOCK);
-    fcntl(ws->breakPipe[1], F_SETFL, fcntl(ws->breakPipe[1], F_GETFL) | O_NONBLOCK);
-
+#if HAS_URING
+    {
+        cchar   *cp;
+        if ((cp = getenv("MPR_IO_URING")) != 0 && atoi(cp) > 0) {
+            if (createUring(ws) == 0) {
+                uringPoll(ws, ws->breakPipe[MPR_READ_PIPE], MPR_READABLE, URING_WAKE);
+                return 0;
+            }
+            mprLog(2, "io_uring is not available, using epoll");
+        }
+    }
+#endif
     memset(&ev, 0, sizeof(ev));
     ev.events = EPOLLIN | EPOLLERR | EPOLLHUP;
     ev.data.fd = ws->breakPipe[MPR_READ_PIPE];
@@ -57,6 +124,9 @@ void mprManageEpoll(MprWaitService *ws, int flags)
 {
     if (flags & MPR_MANAGE_MARK) {
         mprMark(ws->events);
+#if HAS_URING
+        mprMark(ws->uring);
+#endif
     
     } else if (flags & MPR_MANAGE_FREE) {
         if (ws->epoll) {
@@ -66,13 +136,26 @@ void mprManageEpoll(MprWaitService *ws, int flags)
         if (ws->breakPipe[0] >= 0) {
             close(ws->breakPipe[0]);
         }
-        if (ws->breakPipe[1] >= 0) {
+        if (ws->breakPipe[1] >= 0 && ws->breakPipe[1] != ws->breakPipe[0]) {
             close(ws->breakPipe[1]);
         }
     }
 }
 
 
+static int growHandlerMap(MprWaitService *ws, int fd)
+{
+    if (fd >= ws->handlerMax) {
+        ws->handlerMax = fd + 32;
+        if ((ws->handlerMap = mprRealloc(ws->handlerMap, sizeof(MprWaitHandler*) * ws->handlerMax)) == 0) {
+            mprAssert(!MPR_ERR_MEMORY);
+            return MPR_ERR_MEMORY;
+        }
+    }
+    return 0;
+}
+
+
 static int growEvents(MprWaitService *ws)
 {
     ws->eventsMax *= 2;
@@ -84,33 +167,31 @@ static int growEvents(MprWaitService *ws)
 }
 
 
+/*
+    Registrations are one-shot and persistent. Once an event fires, the fd stays registered but disarmed, so re-arming 
+    costs a single EPOLL_CTL_MOD instead of a DEL and an ADD. The handlerMap records the handler that owns the 
+    registration for each fd (armed or not) and notifierIndex is set to the fd while the handler is registered.
+ */
 int mprNotifyOn(MprWaitService *ws, MprWaitHandler *wp, int mask)
 {
     struct epoll_event  ev;
-    int                 fd, rc;
+    int                 fd, rc, owner;
 
     mprAssert(wp);
     fd = wp->fd;
 
     lock(ws);
-    if (wp->desiredMask != mask) {
+#if HAS_URING
+    if (ws->uring) {
+        rc = uringNotifyOn(ws, wp, mask);
+        unlock(ws);
+        return rc;
+    }
+#endif
+    owner = (wp->notifierIndex >= 0 && fd < ws->handlerMax && ws->handlerMap[fd] == wp);
+    if (wp->desiredMask != mask || (mask == 0 && wp->notifierIndex >= 0)) {
         memset(&ev, 0, sizeof(ev));
         ev.data.fd = fd;
-        if (wp->desiredMask & MPR_READABLE) {
-            ev.events |= (EPOLLIN | EPOLLHUP);
-        }
-        if (wp->desiredMask & MPR_WRITABLE) {
-            ev.events |= EPOLLOUT;
-        }
-        if (ev.events) {
-            rc = epoll_ctl(ws->epoll, EPOLL_CTL_DEL, fd, &ev);
-#if UNUSED && KEEP
-            if (rc != 0) {
-                mprError("Epoll del error %d on fd %d\n", errno, fd);
-            }
-#endif
-        }
-        ev.events = 0;
         if (mask & MPR_READABLE) {
             ev.events |= (EPOLLIN | EPOLLHUP);
         }
@@ -118,22 +199,45 @@ int mprNotifyOn(MprWaitService *ws, MprWaitHandler *wp, int mask)
             ev.events |= EPOLLOUT;
         }
         if (ev.events) {
-            rc = epoll_ctl(ws->epoll, EPOLL_CTL_ADD, fd, &ev);
+            if (growHandlerMap(ws, fd) < 0) {
+                unlock(ws);
+                return MPR_ERR_MEMORY;
+            }
+            mprAssert(ws->handlerMap[fd] == 0 || ws->handlerMap[fd] == wp || ws->handlerMap[fd]->desiredMask == 0);
+            ev.events |= EPOLLONESHOT;
+            /*
+                The fd may have been closed and reused since it was registered (ENOENT), or another (stale) handler
+                may still own the registration (EEXIST).
+             */
+            if (owner) {
+                rc = epoll_ctl(ws->epoll, EPOLL_CTL_MOD, fd, &ev);
+                if (rc != 0 && errno == ENOENT) {
+                    rc = epoll_ctl(ws->epoll, EPOLL_CTL_ADD, fd, &ev);
+                }
+            } else {
+                rc = epoll_ctl(ws->epoll, EPOLL_CTL_ADD, fd, &ev);
+                if (rc != 0 && errno == EEXIST) {
+                    rc = epoll_ctl(ws->epoll, EPOLL_CTL_MOD, fd, &ev);
+                }
+            }
             if (rc != 0) {
                 mprError("Epoll add error %d on fd %d\n", errno, fd);
             }
-        }
-        if (mask && fd >= ws->handlerMax) {
-            ws->handlerMax = fd + 32;
-            if ((ws->handlerMap = mprRealloc(ws->handlerMap, sizeof(MprWaitHandler*) * ws->handlerMax)) == 0) {
-                mprAssert(!MPR_ERR_MEMORY);
-                return MPR_ERR_MEMORY;
+            if (ws->handlerMap[fd] && ws->handlerMap[fd] != wp) {
+                ws->handlerMap[fd]->notifierIndex = -1;
             }
+            ws->handlerMap[fd] = wp;
+            wp->notifierIndex = fd;
+
+        } else if (wp->notifierIndex >= 0) {
+            if (owner) {
+                epoll_ctl(ws->epoll, EPOLL_CTL_DEL, fd, &ev);
+                ws->handlerMap[fd] = 0;
+            }
+            wp->notifierIndex = -1;
         }
-        mprAssert(ws->handlerMap[fd] == 0 || ws->handlerMap[fd] == wp);
         wp->desiredMask = mask;
     }
-    ws->handlerMap[fd] = (mask) ? wp : 0;
     unlock(ws);
     return 0;
 }
@@ -204,6 +308,13 @@ void mprWaitForIO(MprWaitService *ws, MprTime timeout)
         mprDoWaitRecall(ws);
         return;
     }
+#if HAS_URING
+    if (ws->uring) {
+        uringWaitForIO(ws, timeout);
+        ws->wakeRequested = 0;
+        return;
+    }
+#endif
     mprYield(MPR_YIELD_STICKY);
     rc = epoll_wait(ws->epoll, ws->events, ws->eventsMax, timeout);
     mprResetYield();
@@ -233,7 +344,7 @@ static void serviceIO(MprWaitService *ws, int count)
         ev = &ws->events[i];
         fd = ev->data.fd;
         mprAssert(fd < ws->handlerMax);
-        if ((wp = ws->handlerMap[fd]) == 0) {
+        if ((wp = ws->handlerMap[fd]) == 0 || wp->desiredMask == 0) {
             char    buf[128];
             if ((ev->events & (EPOLLIN | EPOLLERR | EPOLLHUP)) && (fd == ws->breakPipe[MPR_READ_PIPE])) {
                 if (read(fd, buf, sizeof(buf)) < 0) {}
@@ -251,35 +362,339 @@ static void serviceIO(MprWaitService *ws, int count)
             mprAssert(mask);
             continue;
         }
+        /*
+            The one-shot registration is now disarmed. The handler re-arms it via mprWaitOn.
+         */
+        wp->presentMask = mask & wp->desiredMask;
+        mask = wp->desiredMask;
+        wp->desiredMask = 0;
+        if (wp->presentMask) {
+            mprQueueIOEvent(wp);
+        } else {
+            /* Not an event of interest */
+            mprNotifyOn(ws, wp, mask);
+        }
+    }
+    unlock(ws);
+}
+
+
+#if HAS_URING
+/*
+    Map the io_uring submission and completion rings. Requires IORING_FEAT_EXT_ARG (Linux 5.11) so that
+    io_uring_enter can wait with a timeout without consuming a submission entry.
+ */
+static void manageUring(MprUring *ur, int flags)
+{
+    if (flags & MPR_MANAGE_FREE) {
+        if (ur->sqes && ur->sqes != MAP_FAILED) {
+            munmap(ur->sqes, ur->sqesSize);
+        }
+        if (ur->cqRing && ur->cqRing != MAP_FAILED && ur->cqRing != ur->sqRing) {
+            munmap(ur->cqRing, ur->cqRingSize);
+        }
+        if (ur->sqRing && ur->sqRing != MAP_FAILED) {
+            munmap(ur->sqRing, ur->sqRingSize);
+        }
+        if (ur->fd >= 0) {
+            close(ur->fd);
+            ur->fd = -1;
+        }
+    }
+}
+
+
+static int createUring(MprWaitService *ws)
+{
+    struct io_uring_params  params;
+    MprUring                *ur;
+    char                    *sq, *cq;
+
+    if ((ur = mprAllocObj(MprUring, manageUring)) == 0) {
+        return MPR_ERR_MEMORY;
+    }
+    memset(&params, 0, sizeof(params));
+    if ((ur->fd = (int) syscall(__NR_io_uring_setup, MPR_EPOLL_SIZE * 4, &params)) < 0) {
+        return MPR_ERR_CANT_INITIALIZE;
+    }
+    if (!(params.features & IORING_FEAT_EXT_ARG)) {
+        manageUring(ur, MPR_MANAGE_FREE);
+        return MPR_ERR_BAD_STATE;
+    }
+    ur->sqEntries = params.sq_entries;
+    ur->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint);
+    ur->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ur->sqRingSize = ur->cqRingSize = max(ur->sqRingSize, ur->cqRingSize);
+    }
+    ur->sqRing = mmap(0, ur->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ur->fd, 
+        IORING_OFF_SQ_RING);
+    if (ur->sqRing == MAP_FAILED) {
+        manageUring(ur, MPR_MANAGE_FREE);
+        return MPR_ERR_CANT_INITIALIZE;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ur->cqRing = ur->sqRing;
+    } else {
+        ur->cqRing = mmap(0, ur->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ur->fd, 
+            IORING_OFF_CQ_RING);
+    }
+    ur->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    ur->sqes = mmap(0, ur->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ur->fd, IORING_OFF_SQES);
+    if (ur->cqRing == MAP_FAILED || ur->sqes == MAP_FAILED) {
+        manageUring(ur, MPR_MANAGE_FREE);
+        return MPR_ERR_CANT_INITIALIZE;
+    }
+    sq = ur->sqRing;
+    cq = ur->cqRing;
+    ur->sqHead = (uint*) (sq + params.sq_off.head);
+    ur->sqTail = (uint*) (sq + params.sq_off.tail);
+    ur->sqMask = (uint*) (sq + params.sq_off.ring_mask);
+    ur->sqArray = (uint*) (sq + params.sq_off.array);
+    ur->cqHead = (uint*) (cq + params.cq_off.head);
+    ur->cqTail = (uint*) (cq + params.cq_off.tail);
+    ur->cqMask = (uint*) (cq + params.cq_off.ring_mask);
+    ur->cqes = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+    ws->uring = ur;
+    return 0;
+}
+
+
+static int uringEnter(MprUring *ur, int submit, int wait, MprTime timeout)
+{
+    struct io_uring_getevents_arg   arg;
+    struct __kernel_timespec        ts;
+    uint                            flags;
+
+    memset(&arg, 0, sizeof(arg));
+    flags = 0;
+    if (wait) {
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000;
+        arg.ts = (uint64) (size_t) &ts;
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    }
+    return (int) syscall(__NR_io_uring_enter, ur->fd, submit, wait ? 1 : 0, flags, &arg, sizeof(arg));
+}
+
+
+/*
+    Get a free submission entry. If the ring is full, submit pending entries immediately. Caller must hold the lock.
+ */
+static struct io_uring_sqe *getSqe(MprWaitService *ws)
+{
+    MprUring                *ur;
+    struct io_uring_sqe     *sqe;
+    uint                    tail;
+
+    ur = ws->uring;
+    tail = *ur->sqTail;
+    if ((tail - __atomic_load_n(ur->sqHead, __ATOMIC_ACQUIRE)) >= ur->sqEntries) {
+        uringEnter(ur, ur->pending, 0, 0);
+        ur->pending = 0;
+        if ((tail - __atomic_load_n(ur->sqHead, __ATOMIC_ACQUIRE)) >= ur->sqEntries) {
+            return 0;
+        }
+    }
+    sqe = &ur->sqes[tail & *ur->sqMask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+
+/*
+    Publish a prepared submission entry. It is given to the kernel by the next io_uring_enter in mprWaitForIO.
+ */
+static void putSqe(MprWaitService *ws, struct io_uring_sqe *sqe)
+{
+    MprUring    *ur;
+    uint        tail;
+
+    ur = ws->uring;
+    tail = *ur->sqTail;
+    ur->sqArray[tail & *ur->sqMask] = (uint) (sqe - ur->sqes);
+    __atomic_store_n(ur->sqTail, tail + 1, __ATOMIC_RELEASE);
+    ur->pending++;
+}
+
+
+/*
+    Add a one-shot poll request for a descriptor
+ */
+static void uringPoll(MprWaitService *ws, int fd, int mask, uint64 tag)
+{
+    struct io_uring_sqe     *sqe;
+    uint                    events;
+
+    if ((sqe = getSqe(ws)) == 0) {
+        mprError("io_uring submission ring is full, cannot poll fd %d", fd);
+        return;
+    }
+    events = 0;
+    if (mask & MPR_READABLE) {
+        events |= POLLIN | POLLHUP;
+    }
+    if (mask & MPR_WRITABLE) {
+        events |= POLLOUT;
+    }
+#if __BYTE_ORDER == __BIG_ENDIAN
+    events = (events << 16) | (events >> 16);
+#endif
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = events;
+    sqe->user_data = tag;
+    putSqe(ws, sqe);
+}
+
+
+static void uringPollRemove(MprWaitService *ws, uint64 tag)
+{
+    struct io_uring_sqe     *sqe;
+
+    if ((sqe = getSqe(ws)) == 0) {
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = tag;
+    sqe->user_data = URING_IGNORE;
+    putSqe(ws, sqe);
+}
+
+
+/*
+    The io_uring equivalent of the epoll registration. Poll requests are one-shot. wp->notifierIndex holds the sequence 
+    number of the outstanding request so stale completions (after a remove or re-registration) are ignored.
+    Caller must hold the lock.
+ */
+static int uringNotifyOn(MprWaitService *ws, MprWaitHandler *wp, int mask)
+{
+    MprUring    *ur;
+    int         fd;
+
+    ur = ws->uring;
+    fd = wp->fd;
+    if (wp->desiredMask == mask && !(mask == 0 && wp->notifierIndex >= 0)) {
+        /* A completed request leaves desiredMask zero but must still be removed from the handlerMap */
+        return 0;
+    }
+    if (wp->desiredMask && wp->notifierIndex >= 0) {
+        uringPollRemove(ws, ((uint64) wp->notifierIndex << 32) | (uint) fd);
+    }
+    if (mask) {
+        if (growHandlerMap(ws, fd) < 0) {
+            return MPR_ERR_MEMORY;
+        }
+        if (ws->handlerMap[fd] && ws->handlerMap[fd] != wp) {
+            ws->handlerMap[fd]->notifierIndex = -1;
+        }
+        ur->seq = (ur->seq + 1) & 0x7FFFFFFF;
+        ws->handlerMap[fd] = wp;
+        wp->notifierIndex = ur->seq;
+        uringPoll(ws, fd, mask, ((uint64) ur->seq << 32) | (uint) fd);
+
+    } else if (wp->notifierIndex >= 0) {
+        if (fd < ws->handlerMax && ws->handlerMap[fd] == wp) {
+            ws->handlerMap[fd] = 0;
+        }
+        wp->notifierIndex = -1;
+    }
+    wp->desiredMask = mask;
+    return 0;
+}
+
+
+/*
+    Submit pending registrations and wait for completions in one system call
+ */
+static void uringWaitForIO(MprWaitService *ws, MprTime timeout)
+{
+    MprUring                *ur;
+    MprWaitHandler          *wp;
+    struct io_uring_cqe     *cqe;
+    uint64                  tag, c;
+    uint                    head, tail;
+    int                     fd, seq, mask, submit;
+
+    ur = ws->uring;
+    lock(ws);
+    submit = ur->pending;
+    ur->pending = 0;
+    unlock(ws);
+
+    mprYield(MPR_YIELD_STICKY);
+    if (uringEnter(ur, submit, 1, timeout) < 0) {
+        if (errno != EINTR && errno != ETIME) {
+            mprLog(7, "io_uring_enter returned errno %d", mprGetOsError());
+        }
+    }
+    mprResetYield();
+
+    lock(ws);
+    head = *ur->cqHead;
+    tail = __atomic_load_n(ur->cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        cqe = &ur->cqes[head & *ur->cqMask];
+        tag = cqe->user_data;
+        if (tag == URING_IGNORE) {
+            continue;
+        }
+        if (tag == URING_WAKE) {
+            if (read(ws->breakPipe[MPR_READ_PIPE], (char*) &c, sizeof(c)) < 0) {}
+            uringPoll(ws, ws->breakPipe[MPR_READ_PIPE], MPR_READABLE, URING_WAKE);
+            continue;
+        }
+        fd = (int) (tag & 0xFFFFFFFF);
+        seq = (int) (tag >> 32);
+        if (fd >= ws->handlerMax || (wp = ws->handlerMap[fd]) == 0 || wp->notifierIndex != seq || 
+                wp->desiredMask == 0) {
+            /* Stale completion for a removed or re-registered handler */
+            continue;
+        }
+        if (cqe->res < 0) {
+            if (cqe->res == -ECANCELED) {
+                continue;
+            }
+            /* Let the handler discover the error via I/O */
+            mask = wp->desiredMask;
+        } else {
+            mask = 0;
+            if (cqe->res & (POLLIN | POLLERR | POLLHUP)) {
+                mask |= MPR_READABLE;
+            }
+            if (cqe->res & POLLOUT) {
+                mask |= MPR_WRITABLE;
+            }
+        }
         wp->presentMask = mask & wp->desiredMask;
+        mask = wp->desiredMask;
+        wp->desiredMask = 0;
         if (wp->presentMask) {
-            struct epoll_event  ev;
-            memset(&ev, 0, sizeof(ev));
-            ev.data.fd = fd;
-            wp->desiredMask = 0;
-            ws->handlerMap[wp->fd] = 0;
-            epoll_ctl(ws->epoll, EPOLL_CTL_DEL, wp->fd, &ev);
             mprQueueIOEvent(wp);
+        } else {
+            uringNotifyOn(ws, wp, mask);
         }
     }
+    __atomic_store_n(ur->cqHead, head, __ATOMIC_RELEASE);
     unlock(ws);
 }
+#endif /* HAS_URING */
 
 
 /*
     Wake the wait service. WARNING: This routine must not require locking. MprEvents in scheduleDispatcher depends on this.
     Must be async-safe.
  */
-void mprWakeNotifier()
+void mprWakeWaitService(MprWaitService *ws)
 {
-    MprWaitService  *ws;
-    int             c;
+    uint64      c;
 
-    ws = MPR->waitService;
     if (!ws->wakeRequested) {
         ws->wakeRequested = 1;
-        c = 0;
-        if (write(ws->breakPipe[MPR_WRITE_PIPE], (char*) &c, 1) < 0) {};
+        /* An eventfd requires an 8 byte write. This is also fine for a pipe */
+        c = 1;
+        if (write(ws->breakPipe[MPR_WRITE_PIPE], (char*) &c, sizeof(c)) < 0) {};
     }
 }
 
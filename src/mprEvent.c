@@ -13,10 +13,13 @@
 /***************************** Forward Declarations ***************************/
 
 static void dequeueEvent(MprEvent *event);
+static int drainInbox(MprDispatcher *dispatcher);
 static void initEvent(MprDispatcher *dispatcher, MprEvent *event, cchar *name, MprTime period, void *proc, 
         void *data, int flgs);
 static void initEventQ(MprEvent *q);
+static void insertEvent(MprDispatcher *dispatcher, MprEvent *event);
 static void manageEvent(MprEvent *event, int flags);
+static void postEvent(MprDispatcher *dispatcher, MprEvent *event);
 static void queueEvent(MprEvent *prior, MprEvent *event);
 
 /************************************* Code ***********************************/
@@ -52,7 +55,11 @@ MprEvent *mprCreateEvent(MprDispatcher *dispatcher, cchar *name, MprTime period,
     }
     initEvent(dispatcher, event, name, period, proc, data, flags);
     if (!(flags & MPR_EVENT_DONT_QUEUE)) {
-        mprQueueEvent(dispatcher, event);
+        if (period == 0 && !(flags & MPR_EVENT_CONTINUOUS)) {
+            postEvent(dispatcher, event);
+        } else {
+            mprQueueEvent(dispatcher, event);
+        }
     }
     return event;
 }
@@ -120,7 +127,6 @@ MprEvent *mprCreateTimerEvent(MprDispatcher *dispatcher, cchar *name, MprTime pe
 void mprQueueEvent(MprDispatcher *dispatcher, MprEvent *event)
 {
     MprEventService     *es;
-    MprEvent            *prior, *q;
 
     mprAssert(dispatcher);
     mprAssert(event);
@@ -129,13 +135,33 @@ void mprQueueEvent(MprDispatcher *dispatcher, MprEvent *event)
     mprAssert(event->magic == MPR_EVENT_MAGIC);
 
     es = dispatcher->service;
+    if (es->stats) {
+        event->queued = mprGetHiResTime();
+    }
 
     lock(es);
+    insertEvent(dispatcher, event);
+    if (dispatcher->enabled) {
+        mprScheduleDispatcher(dispatcher);
+    }
+    unlock(es);
+}
+
+
+/*
+    Insert an event in due order. Must be locked when called.
+ */
+static void insertEvent(MprDispatcher *dispatcher, MprEvent *event)
+{
+    MprEvent    *prior, *q;
+
+    /*
+        Search backwards from the tail. Timers and timeouts are mostly queued in due order, so this is typically O(1).
+        Finding the earliest dispatcher across the service uses the waitHeap (see mprDispatcher.c).
+     */
     q = dispatcher->eventQ;
     for (prior = q->prev; prior != q; prior = prior->prev) {
-        if (event->due > prior->due) {
-            break;
-        } else if (event->due == prior->due) {
+        if (event->due >= prior->due) {
             break;
         }
     }
@@ -145,14 +171,111 @@ void mprQueueEvent(MprDispatcher *dispatcher, MprEvent *event)
     mprAssert(prior->prev);
     
     queueEvent(prior, event);
-    es->eventCount++;
-    if (dispatcher->enabled) {
-        mprScheduleDispatcher(dispatcher);
+    dispatcher->service->eventCount++;
+}
+
+
+/*
+    Post an immediate event without taking the event service lock. Events are pushed onto the dispatcher inbox, a 
+    lock-free multi-producer stack. The first poster also lists the dispatcher on the service inbox and wakes the 
+    event loop which moves the events onto the dispatcher queue in arrival order (see mprServicePostedEvents).
+ */
+static void postEvent(MprDispatcher *dispatcher, MprEvent *event)
+{
+    MprEventService     *es;
+    MprEventStats       *stats;
+    MprDispatcher       *top;
+    MprEvent            *head;
+
+    es = dispatcher->service;
+    if ((stats = es->stats) != 0) {
+        event->queued = mprGetHiResTime();
+    }
+    do {
+        head = dispatcher->inbox;
+        event->inboxNext = head;
+    } while (!mprAtomicCas((void**) &dispatcher->inbox, head, event));
+
+    /*
+        A non-null inboxNext claims the dispatcher. It stays claimed until the event loop removes it from the list.
+     */
+    if (mprAtomicCas((void**) &dispatcher->inboxNext, 0, MPR_INBOX_END)) {
+        do {
+            top = es->inbox;
+            dispatcher->inboxNext = top ? top : MPR_INBOX_END;
+        } while (!mprAtomicCas((void**) &es->inbox, top, dispatcher));
+        if (es->waitService) {
+            mprWakeWaitService(es->waitService);
+            if (stats) {
+                mprAtomicAdd(&stats->wakeups, 1);
+            }
+        }
+    }
+    if (dispatcher->waitingOnCond) {
+        mprSignalDispatcher(dispatcher);
+    }
+}
+
+
+/*
+    Move posted events from the inbox of all listed dispatchers onto their event queues. Called by the event loop.
+ */
+void mprServicePostedEvents(MprEventService *es)
+{
+    MprDispatcher   *dp, *next;
+
+    if (es->inbox == 0) {
+        return;
+    }
+    do {
+        dp = es->inbox;
+    } while (!mprAtomicCas((void**) &es->inbox, dp, 0));
+
+    lock(es);
+    for (; dp && dp != MPR_INBOX_END; dp = next) {
+        next = dp->inboxNext;
+        /* Release the claim before draining so later posts will relist the dispatcher */
+        dp->inboxNext = 0;
+        mprAtomicBarrier();
+        if (drainInbox(dp) && dp->enabled && !dp->destroyed) {
+            mprScheduleDispatcher(dp);
+        }
     }
     unlock(es);
 }
 
 
+/*
+    Queue the posted events for a dispatcher. Returns the number of events queued. Must be locked when called.
+ */
+static int drainInbox(MprDispatcher *dispatcher)
+{
+    MprEvent    *event, *next, *prior;
+    int         count;
+
+    do {
+        event = dispatcher->inbox;
+    } while (event && !mprAtomicCas((void**) &dispatcher->inbox, event, 0));
+
+    /* The inbox is newest first so reverse it */
+    for (prior = 0; event; event = next) {
+        next = event->inboxNext;
+        event->inboxNext = prior;
+        prior = event;
+    }
+    for (count = 0, event = prior; event; event = next) {
+        next = event->inboxNext;
+        event->inboxNext = 0;
+        /* Skip events that have since been removed or explicitly queued */
+        if (event->dispatcher == dispatcher && !dispatcher->destroyed && event->next == 0) {
+            insertEvent(dispatcher, event);
+            count++;
+        }
+    }
+    return count;
+}
+
+
 void mprRemoveEvent(MprEvent *event)
 {
     MprEventService     *es;
@@ -230,6 +353,9 @@ MprEvent *mprGetNextEvent(MprDispatcher *dispatcher)
     event = 0;
 
     lock(es);
+    if (dispatcher->inbox) {
+        drainInbox(dispatcher);
+    }
     next = dispatcher->eventQ->next;
     if (next != dispatcher->eventQ) {
         if (next->due <= es->now) {
@@ -254,6 +380,9 @@ int mprGetEventCount(MprDispatcher *dispatcher)
     es = dispatcher->service;
 
     lock(es);
+    if (dispatcher->inbox) {
+        drainInbox(dispatcher);
+    }
 	count = 0;
     for (event = dispatcher->eventQ->next; event != dispatcher->eventQ; event = event->next) {
         mprAssert(event->magic == MPR_EVENT_MAGIC);
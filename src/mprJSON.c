@@ -354,6 +354,29 @@ cchar *mprSerialize(MprObj *obj, int flags)
 }
 
 
+/*
+    Set a numeric property. Numbers are stored as strings like other deserialized JSON values.
+ */
+void mprSetJsonNumber(MprHash *obj, cchar *key, int64 value)
+{
+    MprKey  *kp;
+
+    if ((kp = mprAddKeyFmt(obj, key, "%Ld", value)) != 0) {
+        kp->type = MPR_JSON_STRING;
+    }
+}
+
+
+void mprSetJsonObj(MprHash *obj, cchar *key, MprHash *value, int type)
+{
+    MprKey  *kp;
+
+    if ((kp = mprAddKey(obj, key, value)) != 0) {
+        kp->type = type;
+    }
+}
+
+
 static char advanceToken(MprJson *jp)
 {
     while (isspace((uchar) *jp->tok)) {
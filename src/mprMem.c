@@ -30,20 +30,21 @@ int stopSeqno = -1;
 
 #define GET_NEXT(mp)                (IS_LAST(mp)) ? NULL : ((MprMem*) ((char*) mp + GET_SIZE(mp)))
 #define GET_REGION(mp)              ((MprRegion*) (((char*) mp) - MPR_ALLOC_ALIGN(sizeof(MprRegion))))
+#define SLAB_BITS                   ((int) (sizeof(ulong) * 8))
 
 /*
-    Macros to set and extract "prior" fields. All accesses (read and write) must be done locked.
+    Macros to set and extract "prior" fields. Updates are done atomically via setField1().
         prior | last << 1 | hasManager
  */
 #define GET_PRIOR(mp)               ((MprMem*) ((mp->field1 & MPR_MASK_PRIOR) >> MPR_SHIFT_PRIOR))
-#define SET_PRIOR(mp, value)        mp->field1 = ((((size_t) value) << MPR_SHIFT_PRIOR) | (mp->field1 & ~MPR_MASK_PRIOR))
+#define SET_PRIOR(mp, value)        setField1(mp, MPR_MASK_PRIOR, ((size_t) value) << MPR_SHIFT_PRIOR)
 #define IS_LAST(mp)                 ((mp->field1 & MPR_MASK_LAST) >> MPR_SHIFT_LAST)
-#define SET_LAST(mp, value)         mp->field1 = ((value << MPR_SHIFT_LAST) | (mp->field1 & ~MPR_MASK_LAST))
+#define SET_LAST(mp, value)         setField1(mp, MPR_MASK_LAST, ((size_t) value) << MPR_SHIFT_LAST)
 #define SET_FIELD1(mp, prior, last, hasManager) mp->field1 = (((size_t) prior) << MPR_SHIFT_PRIOR) | \
                                     ((last) << MPR_SHIFT_LAST) | ((hasManager) << MPR_SHIFT_HAS_MANAGER)
 
 #define HAS_MANAGER(mp)             ((int) ((mp->field1 & MPR_MASK_HAS_MANAGER) >> MPR_SHIFT_HAS_MANAGER))
-#define SET_HAS_MANAGER(mp, value)  mp->field1 = ((mp->field1 & ~MPR_MASK_HAS_MANAGER) | (value << MPR_SHIFT_HAS_MANAGER))
+#define SET_HAS_MANAGER(mp, value)  setField1(mp, MPR_MASK_HAS_MANAGER, ((size_t) value) << MPR_SHIFT_HAS_MANAGER)
 
 /*
     Macros to set and extract "size" fields. Accesses can be done unlocked. Updates must be done lock-free.
@@ -109,6 +110,13 @@ int stopSeqno = -1;
     #define INC(field)
 #endif
 
+/*
+    Test if a block is due to be freed by the sweeper. Unmarked old blocks are only freed by full collections.
+    Unmarked young blocks are retained if a minor collection could not prove them unreferenced. See checkSuspects().
+ */
+#define IS_DEAD(mp)                 ((GET_GEN(mp) == heap->dead && !heap->retainYoung) || \
+                                        (heap->sweepOld && GET_GEN(mp) == heap->old))
+
 #define INIT_BLK(mp, size, hasManager, last, prior) if (1) { \
     SET_FIELD1(mp, prior, last, hasManager); \
     SET_FIELD2(mp, size, heap->active, heap->eternal, 0); \
@@ -117,11 +125,20 @@ int stopSeqno = -1;
     SET_NAME(mp, NULL); \
     } else
 
-#define lockHeap()              mprSpinLock(&heap->heapLock);
+/*
+    Lock ordering: the heap lock must be acquired before any free queue lock
+ */
+#define lockHeap()              lockSpin(&heap->heapLock);
 #define unlockHeap()            mprSpinUnlock(&heap->heapLock);
+#define lockQueue(index)        lockSpin(&heap->freeLocks[index]);
+#define unlockQueue(index)      mprSpinUnlock(&heap->freeLocks[index]);
 
 #define percent(a,b) ((int) ((a) * 100 / (b)))
 
+#if (LINUX && !__UCLIBC__) || MACOSX
+    #define HAS_BACKTRACE 1
+#endif
+
 /*
     Fast find first/last bit set
  */
@@ -159,15 +176,47 @@ static void allocException(int cause, ssize size);
 static void checkYielded();
 static void dummyManager(void *ptr, int flags);
 static ssize fastMemSize();
+static uint64 getCacheHits();
 static void *getNextRoot();
 static void getSystemInfo();
 static void initGen();
 static void mark();
 static void marker(void *unused, MprThread *tp);
+static void markerHelper(MprMarkStack *ms, MprThread *tp);
 static void markRoots();
+static void markDirty();
+static void markArenas();
+static int prepareMinor();
+static void promoteBlock(MprMem *mp);
+static int isYoung(cvoid *ptr);
+static void scanBlock(MprMem *mp);
+static void checkSuspects();
+static int readDirtyPages(MprRegion *region);
+static int isDirty(MprRegion *region, MprMem *mp, int allDirty);
+static void clearDirtyPages();
+static int checkSoftDirty();
+static int growTable(void **table, ssize *max, ssize need, ssize size);
+static int compareRegions(cvoid *p1, cvoid *p2);
+static void drainMarks(MprMarkStack *ms);
+static void finishParallelMark();
+static MprMarkStack *getMarkStack();
+static int hasMarkWork();
+static int initMarkStack(MprMarkStack *ms);
+static void markParallel(MprMarkStack *ms, cvoid *ptr, MprMem *mp);
+static cvoid *popMark(MprMarkStack *ms);
+static void pushMark(MprMarkStack *ms, cvoid *ptr);
+static void startMarkers();
+static int startParallelMark();
+static int stealMarks(MprMarkStack *ms);
+static void updatePauseStats(MprTime pause);
 static void nextGen();
 static int pauseThreads();
 static void sweep();
+static MprRegion *claimRegion();
+static void finishSweep();
+static void releaseRegions();
+static void sweepRegion(MprRegion *region);
+static int sweepNextRegion();
 static void resumeThreads();
 static void triggerGC(int flags);
 
@@ -193,16 +242,37 @@ static void monitorStack();
 
 static int initFree();
 static MprMem *allocMem(ssize size, int flags);
+static MprMem *allocFromHeap(int index, ssize required, int flags);
+static MprMem *allocFromCache(MprMemCache *cache, int index, ssize required, int flags);
+static MprMemCache *getCache();
+static int refillCache(MprMemCache *cache, int index, ssize required);
+static MprMem *allocFromSlab(int index, ssize required, int flags);
+static MprRegion *createSlab(int index, ssize size);
+static MprMem *getSlabBlock(int index);
+static void linkSlab(MprRegion *region);
+static void unlinkSlab(MprRegion *region);
+static void sweepSlab(MprRegion *region);
 static MprMem *freeBlock(MprMem *mp);
 static int getQueueIndex(ssize size, int roundup);
 static MprMem *growHeap(ssize size, int flags);
+static void *allocRegion(ssize size);
+static void releasePages(MprMem *mp);
 static void linkBlock(MprMem *mp); 
 static void unlinkBlock(MprFreeMem *fp);
+static int claimBlock(MprMem *mp);
+static void atomicAdd(volatile ssize *ptr, ssize value);
+static void setMapBits(volatile ssize *map, ssize bits);
+static void clearMapBits(volatile ssize *map, ssize bits);
+static void setField1(MprMem *mp, size_t mask, size_t value);
+static void lockSpin(MprSpin *lock);
 static void *vmalloc(ssize size, int mode);
 static void vmfree(void *ptr, ssize size);
 #if BIT_MEMORY_STATS
     static MprFreeMem *getQueue(ssize size);
 #endif
+static void sampleAlloc(MprMem *mp, ssize size);
+static void recordSample(MprMemProfile *pp, MprMem *mp, ssize weight);
+static void pruneProfile();
 
 /************************************* Code ***********************************/
 
@@ -250,6 +320,10 @@ Mpr *mprCreateMemService(MprManager manager, int flags)
     heap->stats.redLine = MAXINT / 100 * 99;
     heap->newQuota = MPR_NEW_QUOTA;
     heap->earlyYieldQuota = MPR_NEW_QUOTA * 5;
+    heap->markers = min(MPR_GC_WORKERS, MPR_MAX_MARKERS - 1);
+    heap->activeMarkers = min(heap->markers, 1);
+    heap->stats.pauseBudget = MPR_GC_PAUSE_BUDGET;
+    heap->lazySweep = 1;
     heap->enabled = !(heap->flags & MPR_DISABLE_GC);
     if (scmp(getenv("MPR_DISABLE_GC"), "1") == 0) {
         heap->enabled = 0;
@@ -285,6 +359,9 @@ Mpr *mprCreateMemService(MprManager manager, int flags)
     heap->mutex = mprCreateLock();
     heap->roots = mprCreateList(-1, MPR_LIST_STATIC_VALUES);
     mprAddRoot(MPR);
+    if (scmp(getenv("MPR_GC_NURSERY"), "1") == 0) {
+        mprSetGCNursery(1);
+    }
     return MPR;
 }
 
@@ -331,6 +408,9 @@ void *mprAllocMem(ssize usize, int flags)
     if ((mp = allocMem(size, flags)) == NULL) {
         return NULL;
     }
+    if (unlikely(heap->profiling)) {
+        sampleAlloc(mp, size);
+    }
     ptr = GET_PTR(mp);
     if (flags & MPR_ALLOC_ZERO) {
         /* Note: real usize may be bigger than requested */
@@ -481,6 +561,7 @@ static int initFree()
         freeq->info.stats.minSize = (int) (size << MPR_ALIGN_SHIFT);
 #endif
         freeq->next = freeq->prev = freeq;
+        mprInitSpinLock(&heap->freeLocks[freeq - heap->freeq]);
     }
     return 0;
 }
@@ -488,33 +569,64 @@ static int initFree()
 
 static MprMem *allocMem(ssize required, int flags)
 {
-    MprFreeMem  *freeq, *fp;
-    MprMem      *mp, *after, *spare;
-    ssize       size, maxBlock;
-    ulong       groupMap, bucketMap;
-    int         bucket, baseGroup, group, index;
+    MprMemCache *cache;
+    MprMem      *mp;
+    int         index;
     
 #if BIT_MEMORY_STACK
     monitorStack();
 #endif
 
     index = getQueueIndex(required, 1);
-    baseGroup = index / MPR_ALLOC_NUM_BUCKETS;
-    bucket = index % MPR_ALLOC_NUM_BUCKETS;
     heap->newCount += index;
     INC(requests);
 
     /*
-        OPT - could break this locked section up.
-        - Can update bit maps conservatively and lockfree
-        - Put locks around freeq unqueue
-        - use unlinkBlock or linkBlock only. Do locks internally in these routines
-        - Probably need unlinkFirst
-        - Long term use lockfree
+        Small blocks are allocated lock-free from the per-thread cache or otherwise from slabs
+     */
+    if (index < MPR_ALLOC_CACHE_QUEUES) {
+        if ((cache = getCache()) != 0) {
+            if ((mp = allocFromCache(cache, index, required, flags)) != 0) {
+                return mp;
+            }
+        } else if ((mp = allocFromSlab(index, required, flags)) != 0) {
+            return mp;
+        }
+    }
+
+    /*
+        Before growing the heap, sweep regions left unswept by the last collection. Retry after each region.
+     */
+    while ((mp = allocFromHeap(index, required, flags)) == 0) {
+        if (!heap->sweepNext || !sweepNextRegion()) {
+            triggerGC(0);
+            return growHeap(required, flags);
+        }
+        INC(lazySweeps);
+    }
+    return mp;
+}
+
+
+/*
+    Allocate a block from the heap free queues. Returns null if there is no suitable free block.
+ */
+static MprMem *allocFromHeap(int index, ssize required, int flags)
+{
+    MprFreeMem  *freeq, *fp;
+    MprMem      *mp, *after, *spare;
+    ssize       size, maxBlock, bit;
+    ssize       groupMap, bucketMap;
+    int         bucket, baseGroup, group;
+
+    baseGroup = index / MPR_ALLOC_NUM_BUCKETS;
+    bucket = index % MPR_ALLOC_NUM_BUCKETS;
+
+    /*
+        The bitmaps are read without locking and may be stale. A bucket bit is only cleared while holding the queue lock
+        and the queue is empty, so a set bit may be spurious but a queue with blocks is never hidden.
+        Threads allocating from different queues do not contend. The heap lock is only taken to split a block.
      */
-    lockHeap();
-    
-    /* Mask groups lower than the base group */
     groupMap = heap->groupMap & ~((((ssize) 1) << baseGroup) - 1);
     while (groupMap) {
         group = (int) (ffsl(groupMap) - 1);
@@ -528,12 +640,15 @@ static MprMem *allocMem(ssize required, int flags)
                 bucket = (int) (ffsl(bucketMap) - 1);
                 index = (group * MPR_ALLOC_NUM_BUCKETS) + bucket;
                 freeq = &heap->freeq[index];
+                bit = ((ssize) 1) << bucket;
 
+                lockQueue(index);
                 if (freeq->next != freeq) {
                     fp = freeq->next;
                     mp = (MprMem*) fp;
                     mprAssert(IS_FREE(mp));
                     unlinkBlock(fp);
+                    unlockQueue(index);
 
                     mprAssert(GET_GEN(mp) == heap->eternal);
                     SET_GEN(mp, heap->active);
@@ -553,6 +668,11 @@ static MprMem *allocMem(ssize required, int flags)
 
                         size = GET_SIZE(mp);
                         if (size > maxBlock) {
+                            /*
+                                Splitting updates the neighbour's prior field which the sweeper also updates when 
+                                coalescing. So must hold the heap lock.
+                             */
+                            lockHeap();
                             spare = (MprMem*) ((char*) mp + required);
                             INIT_BLK(spare, size - required, 0, IS_LAST(mp), mp);
                             if ((after = GET_NEXT(spare)) != NULL) {
@@ -564,24 +684,309 @@ static MprMem *allocMem(ssize required, int flags)
                             mprAtomicBarrier();
                             INC(splits);
                             linkBlock(spare);
+                            unlockHeap();
                         }
                     }
-                    unlockHeap();
                     return mp;
                 }
-                bucketMap &= ~(((ssize) 1) << bucket);
-                heap->bucketMap[group] &= ~(((ssize) 1) << bucket);
+                clearMapBits(&heap->bucketMap[group], bit);
+                unlockQueue(index);
+                bucketMap &= ~bit;
+            }
+            bit = ((ssize) 1) << group;
+            groupMap &= ~bit;
+            if (heap->bucketMap[group] == 0) {
+                /*
+                    Recheck after clearing as linkBlock may have just set a bucket bit. It sets the group bit after.
+                 */
+                clearMapBits(&heap->groupMap, bit);
+                if (heap->bucketMap[group] != 0) {
+                    setMapBits(&heap->groupMap, bit);
+                }
             }
-            groupMap &= ~(((ssize) 1) << group);
-            heap->groupMap &= ~(((ssize) 1) << group);
 #if UNUSED && KEEP
             triggerGC(0);
 #endif
         }
     }
+    return 0;
+}
+
+
+/*
+    Return the allocation cache for the current thread. Returns null for foreign threads and during startup.
+ */
+static MprMemCache *getCache()
+{
+    MprThreadService    *ts;
+    MprThread           *tp;
+
+    if ((ts = MPR->threadService) == 0 || ts->local == 0) {
+        return 0;
+    }
+    if ((tp = mprGetThreadData(ts->local)) == 0) {
+        return 0;
+    }
+    return &tp->cache;
+}
+
+
+/*
+    Allocate a block from a per-thread cache. The cache is only accessed by its owning thread so no locking is required.
+    Cached blocks are the exact size for the queue index.
+ */
+static MprMem *allocFromCache(MprMemCache *cache, int index, ssize required, int flags)
+{
+    MprFreeMem  *fp;
+    MprMem      *mp;
+
+    if ((fp = cache->freeq[index]) == 0) {
+        if (!refillCache(cache, index, required)) {
+            return 0;
+        }
+        fp = cache->freeq[index];
+    }
+    cache->freeq[index] = fp->next;
+    cache->count[index]--;
+    cache->hits++;
+    mp = (MprMem*) fp;
+    mprAssert(!IS_FREE(mp));
+    mprAssert(GET_GEN(mp) == heap->eternal);
+    SET_GEN(mp, heap->active);
+    mprAtomicBarrier();
+    if (flags & MPR_ALLOC_MANAGER) {
+        SET_MANAGER(mp, dummyManager);
+        SET_HAS_MANAGER(mp, 1);
+    }
+    CHECK(mp);
+    return mp;
+}
+
+
+/*
+    Refill a per-thread cache queue with a batch of blocks. Blocks are taken from the matching heap free queue. 
+    If that queue is empty, the blocks are taken from a slab for the block size. Cached blocks are marked eternal
+    and not-free so the sweeper will neither collect nor coalesce them. Returns the count of blocks added.
+ */
+static int refillCache(MprMemCache *cache, int index, ssize required)
+{
+    MprFreeMem  *freeq, *fp;
+    MprMem      *mp;
+    int         count;
+
+    freeq = &heap->freeq[index];
+    lockQueue(index);
+    for (count = 0; count < MPR_ALLOC_CACHE_BATCH && freeq->next != freeq; count++) {
+        fp = freeq->next;
+        unlinkBlock(fp);
+        mp = (MprMem*) fp;
+        mprAssert(GET_SIZE(mp) == required);
+        fp->next = cache->freeq[index];
+        cache->freeq[index] = fp;
+        cache->count[index]++;
+    }
+    unlockQueue(index);
+    lockHeap();
+    while (count == 0) {
+        for (; count < MPR_ALLOC_CACHE_BATCH && (mp = getSlabBlock(index)) != 0; count++) {
+            fp = (MprFreeMem*) mp;
+            fp->next = cache->freeq[index];
+            cache->freeq[index] = fp;
+            cache->count[index]++;
+        }
+        if (count == 0) {
+            unlockHeap();
+            if (!createSlab(index, required)) {
+                return 0;
+            }
+            lockHeap();
+        }
+    }
+    heap->stats.cached += count * required;
+    heap->stats.cacheRefills++;
     unlockHeap();
+    return count;
+}
+
+
+/*
+    Return all blocks in a per-thread cache to the heap. Called when a thread exits. The blocks are not linked directly
+    onto the free queues as they may be adjacent to free blocks and only the sweeper coalesces. Rather, they are made
+    ordinary unreferenced allocations so the next collection will free and coalesce them.
+ */
+void mprFlushMemCache(MprMemCache *cache)
+{
+    MprFreeMem  *fp, *next;
+    MprMem      *mp;
+    int         index;
+
+    if (cache == 0 || heap == 0) {
+        return;
+    }
+    lockHeap();
+    for (index = 0; index < MPR_ALLOC_CACHE_QUEUES; index++) {
+        for (fp = cache->freeq[index]; fp; fp = next) {
+            next = fp->next;
+            mp = (MprMem*) fp;
+            heap->stats.cached -= GET_SIZE(mp);
+            SET_GEN(mp, heap->active);
+        }
+        cache->freeq[index] = 0;
+        cache->count[index] = 0;
+    }
+    mprAtomicBarrier();
+    heap->cacheHits += cache->hits;
+    heap->stats.cacheDrains++;
+    cache->hits = 0;
+    unlockHeap();
+}
+
+
+/*
+    Allocate a block from a slab for a small block size. Used when the current thread does not have a cache.
+ */
+static MprMem *allocFromSlab(int index, ssize required, int flags)
+{
+    MprMem      *mp;
+
+    lockHeap();
+    while ((mp = getSlabBlock(index)) == 0) {
+        unlockHeap();
+        if (!createSlab(index, required)) {
+            return 0;
+        }
+        lockHeap();
+    }
+    unlockHeap();
+    SET_GEN(mp, heap->active);
+    mprAtomicBarrier();
+    if (flags & MPR_ALLOC_MANAGER) {
+        SET_MANAGER(mp, dummyManager);
+        SET_HAS_MANAGER(mp, 1);
+    }
+    CHECK(mp);
+    return mp;
+}
+
+
+/*
+    Create a slab region dedicated to one small block size. Free slab blocks are tracked by a bitmap rather than by
+    the free queues and slab blocks are never split or coalesced. Blocks retain standard headers so they can be marked,
+    managed and traversed like any other block.
+ */
+static MprRegion *createSlab(int index, ssize size)
+{
+    MprRegion   *region;
+    MprMem      *mp, *prior;
+    ssize       rsize, msize;
+    int         count, i;
+
+    mprAssert(size >= (ssize) sizeof(MprFreeMem));
+
     triggerGC(0);
-    return growHeap(required, flags);
+    rsize = MPR_ALLOC_ALIGN(sizeof(MprRegion));
+    count = (int) ((MPR_SLAB_SIZE - rsize) / size);
+    msize = MPR_ALLOC_ALIGN(((count + SLAB_BITS - 1) / SLAB_BITS) * sizeof(ulong));
+    count = (int) ((MPR_SLAB_SIZE - rsize - msize) / size);
+
+    if ((region = mprVirtAlloc(MPR_SLAB_SIZE, MPR_MAP_READ | MPR_MAP_WRITE)) == NULL) {
+        return 0;
+    }
+    mprInitSpinLock(&region->lock);
+    region->size = MPR_SLAB_SIZE;
+    region->freeable = 0;
+    region->slabMap = (ulong*) (((char*) region) + rsize);
+    region->start = (MprMem*) (((char*) region->slabMap) + msize);
+    region->slabSize = size;
+    region->slabCount = count;
+    region->slabFree = count;
+    region->slabIndex = index;
+    region->nextSlab = region->prevSlab = 0;
+    memset(region->slabMap, 0, msize);
+
+    prior = NULL;
+    for (i = 0; i < count; i++) {
+        mp = (MprMem*) (((char*) region->start) + (i * size));
+        INIT_BLK(mp, size, 0, (i == count - 1), prior);
+        SET_FIELD2(mp, size, heap->eternal, UNMARKED, 1);
+        region->slabMap[i / SLAB_BITS] |= ((ulong) 1) << (i % SLAB_BITS);
+        prior = mp;
+    }
+    lockHeap();
+    region->next = heap->regions;
+    heap->regions = region;
+    heap->gcStats.growths++;
+    heap->gcStats.lastGrowth = MPR_SLAB_SIZE;
+    heap->gcStats.lastGrowthTime = mprGetTime();
+    linkSlab(region);
+    heap->stats.slabs++;
+    unlockHeap();
+    return region;
+}
+
+
+/*
+    Take a free block from a slab. The block is returned not-free and in the eternal generation. Must be called locked.
+ */
+static MprMem *getSlabBlock(int index)
+{
+    MprRegion   *region;
+    MprMem      *mp;
+    ulong       *map;
+    int         bit, word;
+
+    if ((region = heap->slabs[index]) == 0) {
+        return 0;
+    }
+    mprAssert(region->slabFree > 0);
+    map = region->slabMap;
+    for (word = 0; map[word] == 0; word++) ;
+    bit = ffsl(map[word]) - 1;
+    map[word] &= ~(((ulong) 1) << bit);
+    if (--region->slabFree == 0) {
+        unlinkSlab(region);
+    }
+    mp = (MprMem*) (((char*) region->start) + (((word * SLAB_BITS) + bit) * region->slabSize));
+    CHECK(mp);
+    mprAssert(IS_FREE(mp));
+    mprAssert(GET_GEN(mp) == heap->eternal);
+    SET_FREE(mp, 0);
+    INC(slabAllocs);
+    return mp;
+}
+
+
+/*
+    Add a slab to the list of slabs with free blocks. Must be called locked.
+ */
+static void linkSlab(MprRegion *region)
+{
+    MprRegion   **head;
+
+    head = &heap->slabs[region->slabIndex];
+    region->prevSlab = 0;
+    region->nextSlab = *head;
+    if (*head) {
+        (*head)->prevSlab = region;
+    }
+    *head = region;
+}
+
+
+/*
+    Remove a slab from the list of slabs with free blocks. Must be called locked.
+ */
+static void unlinkSlab(MprRegion *region)
+{
+    if (region->prevSlab) {
+        region->prevSlab->nextSlab = region->nextSlab;
+    } else {
+        heap->slabs[region->slabIndex] = region->nextSlab;
+    }
+    if (region->nextSlab) {
+        region->nextSlab->prevSlab = region->prevSlab;
+    }
+    region->nextSlab = region->prevSlab = 0;
 }
 
 
@@ -600,6 +1005,10 @@ static MprMem *growHeap(ssize required, int flags)
     rsize = MPR_ALLOC_ALIGN(sizeof(MprRegion));
     size = max(required + rsize, (ssize) heap->chunkSize);
     size = MPR_PAGE_ALIGN(size, memStats.pageSize);
+    if (heap->placement & MPR_MEM_HUGE_PAGES) {
+        size = max(size, (ssize) heap->hugeChunkSize);
+        size = MPR_PAGE_ALIGN(size, MPR_HUGE_PAGE_SIZE);
+    }
     if (size < 0 || size >= ((ssize) 1 << MPR_SIZE_BITS)) {
         allocException(MPR_MEM_TOO_BIG, size);
         return 0;
@@ -614,13 +1023,14 @@ static MprMem *growHeap(ssize required, int flags)
     }
 }
 #endif
-    if ((region = mprVirtAlloc(size, MPR_MAP_READ | MPR_MAP_WRITE)) == NULL) {
+    if ((region = allocRegion(size)) == NULL) {
         return 0;
     }
     mprInitSpinLock(&((MprRegion*) region)->lock);
     region->size = size;
     region->start = (MprMem*) (((char*) region) + rsize);
     region->freeable = 0;
+    region->slabMap = 0;
     mp = (MprMem*) region->start;
     hasManager = (flags & MPR_ALLOC_MANAGER) ? 1 : 0;
     spareLen = size - required - rsize;
@@ -637,6 +1047,9 @@ static MprMem *growHeap(ssize required, int flags)
     lockHeap();
     region->next = heap->regions;
     heap->regions = region;
+    heap->gcStats.growths++;
+    heap->gcStats.lastGrowth = size;
+    heap->gcStats.lastGrowthTime = mprGetTime();
 
     if (spareLen > 0) {
         mprAssert(spareLen >= sizeof(MprFreeMem));
@@ -654,8 +1067,75 @@ static MprMem *growHeap(ssize required, int flags)
 
 
 /*
-    Free a block. MUST only ever be called by the sweeper. The sweeper takes advantage of the fact that only it 
-    coalesces blocks.
+    Allocate virtual memory for a heap region applying the region placement policy
+ */
+static void *allocRegion(ssize size)
+{
+    char    *ptr;
+#if LINUX && VALLOC
+    char    *aligned;
+    ulong   mask;
+    uint    cpu, node;
+
+    if (heap->placement & MPR_MEM_HUGE_PAGES) {
+        /*
+            Over-allocate and trim so the region is aligned on a huge page boundary
+         */
+        mprAssert(MPR_PAGE_ALIGNED(size, MPR_HUGE_PAGE_SIZE));
+        if ((ptr = mprVirtAlloc(size + MPR_HUGE_PAGE_SIZE, MPR_MAP_READ | MPR_MAP_WRITE)) == NULL) {
+            return 0;
+        }
+        aligned = (char*) MPR_PAGE_ALIGN(ptr, MPR_HUGE_PAGE_SIZE);
+        if (aligned > ptr) {
+            mprVirtFree(ptr, aligned - ptr);
+        }
+        if ((aligned + size) < (ptr + size + MPR_HUGE_PAGE_SIZE)) {
+            mprVirtFree(aligned + size, (ptr + MPR_HUGE_PAGE_SIZE) - aligned);
+        }
+        ptr = aligned;
+        madvise(ptr, size, MADV_HUGEPAGE);
+    } else 
+#endif
+    if ((ptr = mprVirtAlloc(size, MPR_MAP_READ | MPR_MAP_WRITE)) == NULL) {
+        return 0;
+    }
+#if LINUX && VALLOC && defined(SYS_mbind) && defined(SYS_getcpu)
+    if (heap->placement & MPR_MEM_NUMA) {
+        /*
+            Prefer the node of the CPU running this thread. MPOL_PREFERRED is 1. Failure is not fatal.
+         */
+        if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0 && node < (sizeof(ulong) * 8)) {
+            mask = ((ulong) 1) << node;
+            syscall(SYS_mbind, ptr, size, 1, &mask, sizeof(ulong) * 8, 0);
+        }
+    }
+#endif
+    return ptr;
+}
+
+
+/*
+    Return the pages of a completely free region to the O/S. The free block header is preserved. 
+    The pages will be zero filled on next use. Must be called unlocked before the block is linked. The block spans 
+    its region so no other thread can reach it until it is linked.
+ */
+static void releasePages(MprMem *mp)
+{
+#if BIT_UNIX_LIKE && VALLOC && defined(MADV_DONTNEED)
+    char    *start, *end;
+
+    start = (char*) MPR_PAGE_ALIGN(((char*) mp) + sizeof(MprFreeMem), memStats.pageSize);
+    end = (char*) (((ssize) (((char*) mp) + GET_SIZE(mp))) & ~((ssize) memStats.pageSize - 1));
+    if (start < end && madvise(start, end - start, MADV_DONTNEED) == 0) {
+        mprAtomicAdd64((int64*) &heap->stats.releases, 1);
+    }
+#endif
+}
+
+
+/*
+    Free a block. MUST only ever be called by a sweeper for a region it has claimed. Sweepers take advantage of the fact
+    that only they coalesce blocks and that blocks never coalesce across regions.
  */
 static MprMem *freeBlock(MprMem *mp)
 {
@@ -673,9 +1153,8 @@ static MprMem *freeBlock(MprMem *mp)
         Coalesce with next if it is free
      */
     next = GET_NEXT(mp);
-    if (next && IS_FREE(next)) {
+    if (next && IS_FREE(next) && claimBlock(next)) {
         BREAKPOINT(next);
-        unlinkBlock((MprFreeMem*) next);
         if ((after = GET_NEXT(next)) != NULL) {
             mprAssert(GET_PRIOR(after) == next);
             SET_PRIOR(after, mp);
@@ -692,9 +1171,8 @@ static MprMem *freeBlock(MprMem *mp)
         Coalesce with previous if it is free
      */
     prev = GET_PRIOR(mp);
-    if (prev && IS_FREE(prev)) {
+    if (prev && IS_FREE(prev) && claimBlock(prev)) {
         BREAKPOINT(prev);
-        unlinkBlock((MprFreeMem*) prev);
         if ((after = GET_NEXT(mp)) != NULL) {
             mprAssert(GET_PRIOR(after) == mp);
             SET_PRIOR(after, prev);
@@ -723,6 +1201,13 @@ static MprMem *freeBlock(MprMem *mp)
         region = GET_REGION(mp);
         region->freeable = 1;
         mprAssert(next == NULL);
+    } else if (GET_PRIOR(mp) == NULL && IS_LAST(mp) && (heap->placement & MPR_MEM_DONTNEED) && !heap->scribble) {
+        /* Don't hold the heap lock over the system call */
+        unlockHeap();
+        releasePages(mp);
+        lockHeap();
+        linkBlock(mp);
+        unlockHeap();
     } else {
         linkBlock(mp);
         unlockHeap();
@@ -786,7 +1271,7 @@ static int getQueueIndex(ssize size, int roundup)
 
 
 /*
-    Add a block to a free q. Must be called locked.
+    Add a block to a free q. Must be called with the heap locked. The free queue is locked here.
     Called by user threads from allocMem and by sweeper from freeBlock.
  */
 static void linkBlock(MprMem *mp) 
@@ -796,22 +1281,17 @@ static void linkBlock(MprMem *mp)
     int         index, group, bucket;
 
     CHECK(mp);
+    size = GET_SIZE(mp);
+    index = getQueueIndex(size, 0);
+    group = index / MPR_ALLOC_NUM_BUCKETS;
+    bucket = index % MPR_ALLOC_NUM_BUCKETS;
 
+    lockQueue(index);
     /* 
         Mark block as free and eternal so sweeper will skip 
      */
-    size = GET_SIZE(mp);
     SET_FIELD2(mp, size, heap->eternal, UNMARKED, 1);
     SET_HAS_MANAGER(mp, 0);
-    
-    /*
-        Set free space bitmap
-     */
-    index = getQueueIndex(size, 0);
-    group = index / MPR_ALLOC_NUM_BUCKETS;
-    bucket = index % MPR_ALLOC_NUM_BUCKETS;
-    heap->groupMap |= (((ssize) 1) << group);
-    heap->bucketMap[group] |= (((ssize) 1) << bucket);
 
     /*
         Link onto free queue
@@ -826,15 +1306,21 @@ static void linkBlock(MprMem *mp)
     mprAssert(fp != fp->next);
     mprAssert(fp != fp->prev);
 
-    heap->stats.bytesFree += size;
+    /*
+        Set free space bitmap. The bucket bit must be set before the group bit. See allocFromHeap.
+     */
+    setMapBits(&heap->bucketMap[group], ((ssize) 1) << bucket);
+    setMapBits(&heap->groupMap, ((ssize) 1) << group);
 #if BIT_MEMORY_STATS
     freeq->info.stats.count++;
 #endif
+    unlockQueue(index);
+    atomicAdd(&heap->stats.bytesFree, size);
 }
 
 
 /*
-    Remove a block from a free q. Must be called locked.
+    Remove a block from a free q. Must be called with the block's free queue locked.
  */
 static void unlinkBlock(MprFreeMem *fp) 
 {
@@ -850,7 +1336,7 @@ static void unlinkBlock(MprFreeMem *fp)
 
     mp = (MprMem*) fp;
     size = GET_SIZE(mp);
-    heap->stats.bytesFree -= size;
+    atomicAdd(&heap->stats.bytesFree, -size);
     mprAssert(IS_FREE(mp));
     SET_FREE(mp, 0);
     mprAtomicBarrier();
@@ -864,24 +1350,113 @@ static void unlinkBlock(MprFreeMem *fp)
 }
 
 
-#if BIT_MEMORY_STATS
-static MprFreeMem *getQueue(ssize size)
-{   
-    MprFreeMem  *freeq;
-    int         index;
-    
-    index = getQueueIndex(size, 0);
-    freeq = &heap->freeq[index];
-    return freeq;
+/*
+    Remove a free neighbour block from its free queue so it can be coalesced. Must be called with the heap locked.
+    Allocating threads remove blocks holding only the queue lock, so the block must be retested once the queue is locked.
+    Returns true if the block was removed.
+ */
+static int claimBlock(MprMem *mp)
+{
+    int     index, claimed;
+
+    index = getQueueIndex(GET_SIZE(mp), 0);
+    lockQueue(index);
+    if ((claimed = (int) IS_FREE(mp)) != 0) {
+        unlinkBlock((MprFreeMem*) mp);
+    }
+    unlockQueue(index);
+    return claimed;
 }
-#endif
 
 
 /*
-    Allocate virtual memory and check a memory allocation request against configured maximums and redlines. 
-    An application-wide memory allocation failure routine can be invoked from here when a memory redline is exceeded. 
-    It is the application's responsibility to set the red-line value suitable for the system.
-    Memory is zereod on all platforms.
+    Lock a heap or free queue spin lock. Acquisitions that must wait are counted in the contention stat.
+ */
+static void lockSpin(MprSpin *lock)
+{
+    if (!mprTrySpinLock(lock)) {
+        atomicAdd(&heap->stats.contention, 1);
+        mprSpinLock(lock);
+    }
+}
+
+
+/*
+    Lock-free add to a word sized counter
+ */
+static void atomicAdd(volatile ssize *ptr, ssize value)
+{
+    ssize   prior;
+
+    do {
+        prior = *ptr;
+    } while (!mprAtomicCas((void* volatile*) ptr, (void*) prior, (cvoid*) (prior + value)));
+}
+
+
+/*
+    Lock-free set of bits in a free space bitmap
+ */
+static void setMapBits(volatile ssize *map, ssize bits)
+{
+    ssize   prior;
+
+    do {
+        prior = *map;
+        if ((prior & bits) == bits) {
+            return;
+        }
+    } while (!mprAtomicCas((void* volatile*) map, (void*) prior, (cvoid*) (prior | bits)));
+}
+
+
+/*
+    Lock-free clear of bits in a free space bitmap
+ */
+static void clearMapBits(volatile ssize *map, ssize bits)
+{
+    ssize   prior;
+
+    do {
+        prior = *map;
+        if ((prior & bits) == 0) {
+            return;
+        }
+    } while (!mprAtomicCas((void* volatile*) map, (void*) prior, (cvoid*) (prior & ~bits)));
+}
+
+
+/*
+    Lock-free update of the prior, last and hasManager fields of a block
+ */
+static void setField1(MprMem *mp, size_t mask, size_t value)
+{
+    size_t  prior;
+
+    do {
+        prior = mp->field1;
+    } while (!mprAtomicCas((void* volatile*) &mp->field1, (void*) prior, (cvoid*) ((prior & ~mask) | value)));
+}
+
+
+#if BIT_MEMORY_STATS
+static MprFreeMem *getQueue(ssize size)
+{   
+    MprFreeMem  *freeq;
+    int         index;
+    
+    index = getQueueIndex(size, 0);
+    freeq = &heap->freeq[index];
+    return freeq;
+}
+#endif
+
+
+/*
+    Allocate virtual memory and check a memory allocation request against configured maximums and redlines. 
+    An application-wide memory allocation failure routine can be invoked from here when a memory redline is exceeded. 
+    It is the application's responsibility to set the red-line value suitable for the system.
+    Memory is zereod on all platforms.
  */
 void *mprVirtAlloc(ssize size, int mode)
 {
@@ -964,6 +1539,182 @@ static void vmfree(void *ptr, ssize size)
 }
 
 
+/************************************ Arenas **********************************/
+/*
+    Arena chunks are obtained via mprVirtAlloc. Blocks are bump-allocated after the chunk header.
+ */
+typedef struct MprArenaChunk {
+    struct MprArenaChunk *next;             /* Next (older) chunk */
+    char                 *used;             /* End of allocated blocks. Set when the chunk is retired */
+    ssize                size;              /* Size of the chunk including the header */
+} MprArenaChunk;
+
+#define ARENA_START(chunk)  ((MprMem*) (((char*) chunk) + MPR_ALLOC_ALIGN(sizeof(MprArenaChunk))))
+
+static void manageArena(MprArena *arena, int flags);
+static void manageArenaBlocks(MprArena *arena, int flags);
+static int growArena(MprArena *arena, ssize required);
+
+
+MprArena *mprCreateArena(ssize chunkSize)
+{
+    MprArena    *arena;
+
+    if ((arena = mprAllocObj(MprArena, manageArena)) == 0) {
+        return 0;
+    }
+    arena->chunkSize = (chunkSize > 0) ? chunkSize : MPR_ARENA_SIZE;
+
+    /*
+        Arena chunks are outside the heap regions so minor collections can't see modified arena blocks via dirty pages.
+        Minor collections trace all live arenas instead. See markArenas().
+     */
+    lockHeap();
+    if ((arena->nextArena = heap->arenas) != 0) {
+        arena->nextArena->prevArena = arena;
+    }
+    heap->arenas = arena;
+    unlockHeap();
+    return arena;
+}
+
+
+static void manageArena(MprArena *arena, int flags)
+{
+    MprArenaChunk   *chunk, *next;
+
+    if (flags & MPR_MANAGE_MARK) {
+        manageArenaBlocks(arena, MPR_MANAGE_MARK);
+
+    } else if (flags & MPR_MANAGE_FREE) {
+        lockHeap();
+        if (arena->prevArena) {
+            arena->prevArena->nextArena = arena->nextArena;
+        } else {
+            heap->arenas = arena->nextArena;
+        }
+        if (arena->nextArena) {
+            arena->nextArena->prevArena = arena->prevArena;
+        }
+        unlockHeap();
+        manageArenaBlocks(arena, MPR_MANAGE_FREE);
+        for (chunk = arena->chunks; chunk; chunk = next) {
+            next = chunk->next;
+            mprVirtFree(chunk, chunk->size);
+        }
+        arena->chunks = 0;
+    }
+}
+
+
+/*
+    Invoke the managers for arena blocks that have managers. Blocks are contiguous within each chunk.
+ */
+static void manageArenaBlocks(MprArena *arena, int flags)
+{
+    MprArenaChunk   *chunk;
+    MprMem          *mp;
+    char            *end;
+
+    if (arena->managed == 0) {
+        return;
+    }
+    for (chunk = arena->chunks; chunk; chunk = chunk->next) {
+        end = (chunk == arena->chunks) ? arena->next : chunk->used;
+        for (mp = ARENA_START(chunk); (char*) mp < end; mp = (MprMem*) (((char*) mp) + GET_SIZE(mp))) {
+            CHECK(mp);
+            if (HAS_MANAGER(mp)) {
+                (GET_MANAGER(mp))(GET_PTR(mp), flags);
+            }
+        }
+    }
+}
+
+
+void *mprArenaAllocMem(MprArena *arena, ssize usize, int flags)
+{
+    MprMem      *mp;
+    ssize       size;
+    int         hasManager, padWords;
+
+    mprAssert(arena);
+    mprAssert(usize >= 0);
+
+    padWords = padding[flags & MPR_ALLOC_PAD_MASK];
+    size = MPR_ALLOC_ALIGN(usize + sizeof(MprMem) + (padWords * sizeof(void*)));
+    if ((arena->end - arena->next) < size && !growArena(arena, size)) {
+        return 0;
+    }
+    mp = (MprMem*) arena->next;
+    arena->next += size;
+    arena->allocated += size;
+
+    /*
+        Arena blocks are eternal so the marker will never change their generation
+     */
+    hasManager = (flags & MPR_ALLOC_MANAGER) ? 1 : 0;
+    INIT_BLK(mp, size, hasManager, 1, NULL);
+    SET_FIELD2(mp, size, heap->eternal, UNMARKED, 0);
+    if (hasManager) {
+        SET_MANAGER(mp, dummyManager);
+        arena->managed++;
+    }
+    if (flags & MPR_ALLOC_ZERO) {
+        memset(GET_PTR(mp), 0, GET_USIZE(mp));
+    }
+    return GET_PTR(mp);
+}
+
+
+/*
+    Start a new chunk big enough for the required block. Space remaining in the current chunk is abandoned.
+ */
+static int growArena(MprArena *arena, ssize required)
+{
+    MprArenaChunk   *chunk;
+    ssize           size;
+
+    size = max(arena->chunkSize, required + MPR_ALLOC_ALIGN(sizeof(MprArenaChunk)));
+    size = MPR_PAGE_ALIGN(size, memStats.pageSize);
+    if ((chunk = mprVirtAlloc(size, MPR_MAP_READ | MPR_MAP_WRITE)) == 0) {
+        return 0;
+    }
+    chunk->size = size;
+    chunk->used = 0;
+    if (arena->chunks) {
+        arena->chunks->used = arena->next;
+    }
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->next = (char*) ARENA_START(chunk);
+    arena->end = ((char*) chunk) + size;
+    return 1;
+}
+
+
+void mprResetArena(MprArena *arena)
+{
+    MprArenaChunk   *chunk, *next;
+
+    if (arena == 0 || arena->chunks == 0) {
+        return;
+    }
+    manageArenaBlocks(arena, MPR_MANAGE_FREE);
+
+    /*
+        Retain the current chunk for reuse and release the rest
+     */
+    chunk = arena->chunks;
+    for (next = chunk->next; next; next = chunk->next) {
+        chunk->next = next->next;
+        mprVirtFree(next, next->size);
+    }
+    arena->next = (char*) ARENA_START(chunk);
+    arena->allocated = 0;
+    arena->managed = 0;
+}
+
+
 /***************************************************** Garbage Colllector *************************************************/
 
 void mprStartGCService()
@@ -977,6 +1728,7 @@ void mprStartGCService()
             } else {
                 mprStartThread(heap->marker);
             }
+            startMarkers();
         }
 #if FUTURE && KEEP
         if (heap->flags & MPR_SWEEP_THREAD) {
@@ -1003,11 +1755,102 @@ void mprStopGCService()
 
 void mprWakeGCService()
 {
+    int     i;
+
     mprSignalCond(heap->markerCond);
+    for (i = 1; i < MPR_MAX_MARKERS; i++) {
+        if (heap->markStacks[i].cond) {
+            mprSignalCond(heap->markStacks[i].cond);
+        }
+    }
     mprResumeThreads();
 }
 
 
+void mprSetGCMarkers(int count)
+{
+    heap->markers = max(0, min(count, MPR_MAX_MARKERS - 1));
+    heap->activeMarkers = min(max(heap->activeMarkers, 1), heap->markers);
+    if (heap->marker) {
+        startMarkers();
+    }
+}
+
+
+void mprSetGCPauseBudget(MprTime budget)
+{
+    heap->stats.pauseBudget = budget;
+}
+
+
+void mprSetGCLazySweep(bool on)
+{
+    heap->lazySweep = on;
+}
+
+
+bool mprSetGCNursery(bool on)
+{
+#if PARALLEL_GC
+    return 0;
+#else
+    MprNursery  *np;
+    ssize       size;
+
+    mprLock(heap->mutex);
+    if (on && heap->nurseryState == 0) {
+        size = MPR_PAGE_ALIGN(sizeof(MprNursery), memStats.pageSize);
+        if ((np = vmalloc(size, MPR_MAP_READ | MPR_MAP_WRITE)) == 0) {
+            mprUnlock(heap->mutex);
+            return 0;
+        }
+        memset(np, 0, sizeof(MprNursery));
+        heap->softDirty = checkSoftDirty();
+        heap->nurseryState = np;
+    }
+    if (on && !heap->nursery) {
+        /* Marks from prior collections are not reset, so start with a full collection */
+        heap->needFull = 1;
+    }
+    heap->nursery = on;
+    mprUnlock(heap->mutex);
+    return heap->softDirty;
+#endif
+}
+
+
+/*
+    Start helper marker threads for parallel marking
+ */
+static void startMarkers()
+{
+    MprMarkStack    *ms;
+    int             i;
+
+    for (i = 1; i <= heap->markers; i++) {
+        ms = &heap->markStacks[i];
+        if (ms->thread) {
+            continue;
+        }
+        if (initMarkStack(ms) < 0 || (ms->cond = mprCreateCond()) == 0) {
+            mprError("Can't initialize parallel marker");
+            heap->markers = i - 1;
+            break;
+        }
+        if ((ms->thread = mprCreateThread("marker", markerHelper, ms, 0)) == 0) {
+            mprError("Can't create parallel marker thread");
+            heap->markers = i - 1;
+            break;
+        }
+        /* Helpers are always yielded so they never delay a collection */
+        ms->thread->stickyYield = 1;
+        ms->thread->yielded = 1;
+        mprStartThread(ms->thread);
+    }
+    heap->activeMarkers = min(heap->activeMarkers, heap->markers);
+}
+
+
 static void triggerGC(int flags)
 {
     if (!heap->gc && ((flags & MPR_FORCE_GC) || (heap->newCount > heap->newQuota))) {
@@ -1029,6 +1872,9 @@ void mprRequestGC(int flags)
     LOG(7, "DEBUG: mprRequestGC");
 
     count = (flags & MPR_COMPLETE_GC) ? 3 : 1;
+    if (flags & MPR_COMPLETE_GC) {
+        heap->needFull = 1;
+    }
     for (i = 0; i < count; i++) {
         if ((flags & MPR_FORCE_GC) || (heap->newCount > heap->newQuota)) {
 #if PARALLEL_GC
@@ -1073,7 +1919,12 @@ static void resumeThreads()
 
 static void mark()
 {
+    MprGCStats  *gs;
+    MprTime     start, markStart, sweepStart;
+
     LOG(7, "GC: mark started");
+    gs = &heap->gcStats;
+    start = mprGetTime();
 
     /*
         When parallel, we mark blocks using the current heap->active mark. After marking, synchronization will rotate
@@ -1094,19 +1945,95 @@ static void mark()
         LOG(6, "If debugging, run the process with -D to enable debug mode.");
         return;
     }
+    gs->lastSync = mprGetTime() - start;
+    gs->totalSync += gs->lastSync;
+
+    /* Dead blocks must all be freed before the dead generation is recycled */
+    finishSweep();
+    gs->lastReclaimed = heap->stats.freed;
+    gs->totalReclaimed += heap->stats.freed;
     nextGen();
+
+    /*
+        With the nursery, survivors are promoted to the old generation by the sweeper and most collections are minor
+        collections that only trace young blocks and modified old blocks. Old blocks are freed by full collections.
+        Collections while stopping are full so that destructors run for all unreferenced blocks.
+     */
+    heap->minor = heap->nursery && !heap->needFull && heap->minorCount < MPR_GC_MINOR_CYCLES && !mprIsStopping();
+    if (heap->minor && prepareMinor() < 0) {
+        heap->minor = 0;
+    }
+    if (heap->minor) {
+        heap->minorCount++;
+        gs->minorCycles++;
+    } else {
+        heap->minorCount = 0;
+        heap->needFull = 0;
+    }
+    heap->promote = heap->nursery;
+    heap->sweepOld = !heap->minor && heap->nurseryState != 0;
+    heap->retainYoung = 0;
 #endif
     heap->priorNewCount = heap->newCount;
     heap->priorFree = heap->stats.bytesFree;
     heap->newCount = 0;
     heap->gc = 0;
     checkYielded();
+    markStart = mprGetTime();
     markRoots();
+    heap->minor = 0;
+    sweepStart = mprGetTime();
+    gs->lastMark = sweepStart - markStart;
+    gs->totalMark += gs->lastMark;
     heap->marking = 0;
     if (!heap->hasSweeper) {
         MPR_MEASURE(7, "GC", "sweep", sweep());
     }
+    if (heap->promote && heap->softDirty) {
+        /* Must follow the sweep which modifies block headers */
+        clearDirtyPages();
+    }
+    gs->lastSweep = mprGetTime() - sweepStart;
+    gs->totalSweep += gs->lastSweep;
     resumeThreads();
+    updatePauseStats(mprGetTime() - start);
+
+    /*
+        Lazy sweep. Free dead blocks concurrently with other threads. They may also sweep regions on demand.
+     */
+    while (heap->sweepNext && sweepNextRegion()) { }
+}
+
+
+/*
+    Track collection pause times against the pause budget. Engage more parallel markers if the budget is exceeded
+    and release them when pauses are well within budget.
+ */
+static void updatePauseStats(MprTime pause)
+{
+    MprMemStats     *stats;
+    MprGCStats      *gs;
+    int             bucket;
+
+    gs = &heap->gcStats;
+    for (bucket = 0; bucket < (MPR_GC_PAUSE_BUCKETS - 1) && pause >= (((MprTime) 1) << bucket); bucket++) { }
+    gs->pauseHistogram[bucket]++;
+    gs->lastPause = pause;
+    gs->maxPause = max(gs->maxPause, pause);
+    gs->totalPause += pause;
+    gs->cycles++;
+
+    stats = &heap->stats;
+    if (stats->pauseBudget > 0) {
+        if (pause > stats->pauseBudget) {
+            stats->pauseOverruns++;
+            if (heap->activeMarkers < heap->markers) {
+                heap->activeMarkers++;
+            }
+        } else if (pause < (stats->pauseBudget / 4) && heap->activeMarkers > 1) {
+            heap->activeMarkers--;
+        }
+    }
 }
 
 
@@ -1120,12 +2047,16 @@ static void mark()
 */
 static void sweep()
 {
-    MprRegion   *region, *nextRegion, *prior;
-    MprMem      *mp, *next;
+    MprRegion   *region;
+    MprMem      *mp;
     MprManager  mgr;
-    
+    int         i;
+
     if (!heap->enabled) {
         LOG(7, "DEBUG: sweep: Abort sweep - GC disabled");
+        /* Survivors were not promoted, so the generations must be rebuilt by a full collection */
+        heap->needFull = heap->promote;
+        heap->promote = 0;
         return;
     }
     LOG(7, "GC: sweep started");
@@ -1137,14 +2068,15 @@ static void sweep()
 
     /*
         Run all destructors first so all destructors can guarantee dependant memory blocks will still exist.
-        Actually free the memory in a 2nd pass below.
+        Actually free the memory in a 2nd pass below. Destructors may run arbitrary code, so they are always run
+        serially while all threads are paused.
      */
     for (region = heap->regions; region; region = region->next) {
         /*
             This code assumes that no other code coalesces blocks and that splitting blocks will be done lock-free
          */
         for (mp = region->start; mp; mp = GET_NEXT(mp)) {
-            if (unlikely(GET_GEN(mp) == heap->dead && HAS_MANAGER(mp))) {
+            if (unlikely(IS_DEAD(mp) && HAS_MANAGER(mp))) {
                 mgr = GET_MANAGER(mp);
                 mprAssert(!IS_FREE(mp));
                 CHECK(mp);
@@ -1155,141 +2087,944 @@ static void sweep()
             }
         }
     }
+    pruneProfile();
     heap->stats.sweepVisited = 0;
     heap->stats.swept = 0;
 
     /*
-        growHeap() will append new regions to the front of heap->regions and so will not race with this code. This code
-        is the only code that frees regions.
-        RACE: Take from the front. Racing with growHeap.
+        Regions are claimed for freeing in list order. growHeap() prepends new regions, so they are never claimed.
      */
-    prior = NULL;
-    for (region = heap->regions; region; region = nextRegion) {
-        mprAssert(region->freeable == 0 || region->freeable == 1);
-        nextRegion = region->next;
+    lockHeap();
+    heap->sweepNext = heap->regions;
+    unlockHeap();
 
-        /*
-            This code assumes that no other code coalesces blocks and that splitting blocks will be done lock-free
+    if (heap->lazySweep && !heap->promote) {
+        /* 
+            Dead blocks are freed after threads resume. See mark() and allocMem(). Promotion must complete while 
+            threads are paused so that later modifications of old blocks are seen by the next minor collection.
          */
-        for (mp = region->start; mp; mp = next) {
-            CHECK(mp);
-            INC(sweepVisited);
-            if (unlikely(GET_GEN(mp) == heap->dead)) {
-                mprAssert(!IS_FREE(mp));
-                CHECK(mp);
-                BREAKPOINT(mp);
-                INC(swept);
-#if BIT_DEBUG && BIT_MEMORY_STATS
-                if (heap->track) {
-                    freeLocation(mp->name, GET_SIZE(mp));
-                }
-#endif
-                heap->stats.freed += GET_SIZE(mp);
-                next = freeBlock(mp);
-            } else {
-                /*
-                    RACE: Block could be allocated here, but will never be coalesced (sweeper is the only one to do that).
-                    So mp->field2 may be reduced so we may skip a newly created block -- no problem. Get it next scan.
-                 */
-                next = GET_NEXT(mp);
-            }
-        }
-        /*
-            The sweeper is the only one who removes regions. 
-            Currently all threads are suspended so no locks needed. FUTURE - When doing parallel collection, do this 
-            lock-free because user code traverses the region list.
-         */ 
-        if (region->freeable) {
-            lockHeap();
-            if (prior) {
-                prior->next = nextRegion;
-            } else {
-                heap->regions = nextRegion;
-            }
-            unlockHeap();
-            LOG(9, "DEBUG: Unpin %p to %p size %d, used %d", region, 
-                ((char*) region) + region->size, region->size,fastMemSize());
-            mprManageSpinLock(&region->lock, MPR_MANAGE_FREE);
-            mprVirtFree(region, region->size);
+        return;
+    }
+    heap->sweeping = 1;
+    mprAtomicBarrier();
+    for (i = 1; i <= heap->activeMarkers; i++) {
+        mprSignalCond(heap->markStacks[i].cond);
+    }
+    finishSweep();
+    heap->sweeping = 0;
+}
+
+
+/*
+    Sweep all remaining regions and wait for other sweepers. Then release freeable regions back to the O/S.
+    Must be called while threads are paused.
+ */
+static void finishSweep()
+{
+    while (sweepNextRegion()) { }
+    while (heap->sweepBusy > 0) {
+        mprNap(0);
+    }
+    releaseRegions();
+}
+
+
+/*
+    Claim the next unswept region. Regions are claimed exclusively so sweepers can free blocks in parallel.
+ */
+static MprRegion *claimRegion()
+{
+    MprRegion   *region;
+
+    lockHeap();
+    if ((region = heap->sweepNext) != 0) {
+        heap->sweepNext = region->next;
+        heap->sweepBusy++;
+    }
+    unlockHeap();
+    return region;
+}
+
+
+/*
+    Claim and sweep one region. Returns false if there are no regions left to sweep.
+ */
+static int sweepNextRegion()
+{
+    MprRegion   *region;
+
+    if ((region = claimRegion()) == 0) {
+        return 0;
+    }
+    sweepRegion(region);
+    lockHeap();
+    heap->sweepBusy--;
+    unlockHeap();
+    return 1;
+}
+
+
+/*
+    Free the dead blocks in a region. This may run while other threads are allocating from the region.
+ */
+static void sweepRegion(MprRegion *region)
+{
+    MprMem      *mp, *next;
+    ssize       freed;
+    int         swept, visited;
+
+    if (region->slabMap) {
+        sweepSlab(region);
+        return;
+    }
+    freed = 0;
+    swept = visited = 0;
+    for (mp = region->start; mp; mp = next) {
+        CHECK(mp);
+        visited++;
+        if (unlikely(IS_DEAD(mp))) {
+            mprAssert(!IS_FREE(mp));
+            CHECK(mp);
+            BREAKPOINT(mp);
+            swept++;
+#if BIT_DEBUG && BIT_MEMORY_STATS
+            if (heap->track) {
+                freeLocation(mp->name, GET_SIZE(mp));
+            }
+#endif
+            freed += GET_SIZE(mp);
+            next = freeBlock(mp);
+        } else {
+            /*
+                RACE: Block could be allocated here, but will never be coalesced (sweeper is the only one to do that).
+                So mp->field2 may be reduced so we may skip a newly created block -- no problem. Get it next scan.
+             */
+            if (heap->promote && !IS_FREE(mp)) {
+                promoteBlock(mp);
+            }
+            next = GET_NEXT(mp);
+        }
+    }
+    lockHeap();
+    heap->stats.sweepVisited += visited;
+    heap->stats.swept += swept;
+    heap->stats.freed += freed;
+    unlockHeap();
+}
+
+
+/*
+    Free the dead blocks in a slab. Slab blocks are freed by setting their bit in the slab bitmap. Blocks are visited 
+    by index rather than by following block sizes. Empty slabs are released if there are other slabs for the block size.
+ */
+static void sweepSlab(MprRegion *region)
+{
+    MprMem      *mp;
+    ulong       bits;
+    ssize       size;
+    int         i, count, swept, word;
+
+    size = region->slabSize;
+    swept = 0;
+    for (word = 0; (word * SLAB_BITS) < region->slabCount; word++) {
+        bits = 0;
+        count = 0;
+        for (i = 0; i < SLAB_BITS && ((word * SLAB_BITS) + i) < region->slabCount; i++) {
+            mp = (MprMem*) (((char*) region->start) + (((word * SLAB_BITS) + i) * size));
+            if (unlikely(IS_DEAD(mp))) {
+                mprAssert(!IS_FREE(mp));
+                CHECK(mp);
+                BREAKPOINT(mp);
+#if BIT_DEBUG && BIT_MEMORY_STATS
+                if (heap->track) {
+                    freeLocation(mp->name, size);
+                }
+#endif
+                SCRIBBLE(mp);
+                SET_HAS_MANAGER(mp, 0);
+                SET_FIELD2(mp, size, heap->eternal, UNMARKED, 1);
+                bits |= ((ulong) 1) << i;
+                count++;
+            } else if (heap->promote && !IS_FREE(mp)) {
+                promoteBlock(mp);
+            }
+        }
+        if (bits) {
+            lockHeap();
+            if (region->slabFree == 0) {
+                linkSlab(region);
+            }
+            region->slabMap[word] |= bits;
+            region->slabFree += count;
+            unlockHeap();
+            swept += count;
+        }
+    }
+    lockHeap();
+    if (region->slabFree == region->slabCount && (region->prevSlab || region->nextSlab)) {
+        unlinkSlab(region);
+        region->freeable = 1;
+        heap->stats.slabs--;
+    }
+    heap->stats.sweepVisited += region->slabCount;
+    heap->stats.swept += swept;
+    heap->stats.freed += swept * size;
+    unlockHeap();
+}
+
+
+/*
+    Release completely free regions back to the O/S. The sweeper is the only one who removes regions.
+    Currently all threads are suspended so no locks needed. FUTURE - When doing parallel collection, do this
+    lock-free because user code traverses the region list.
+ */
+static void releaseRegions()
+{
+    MprRegion   *region, *nextRegion, *prior;
+
+    prior = NULL;
+    for (region = heap->regions; region; region = nextRegion) {
+        mprAssert(region->freeable == 0 || region->freeable == 1);
+        nextRegion = region->next;
+        if (region->freeable) {
+            lockHeap();
+            if (prior) {
+                prior->next = nextRegion;
+            } else {
+                heap->regions = nextRegion;
+            }
+            unlockHeap();
+            LOG(9, "DEBUG: Unpin %p to %p size %d, used %d", region,
+                ((char*) region) + region->size, region->size,fastMemSize());
+            mprManageSpinLock(&region->lock, MPR_MANAGE_FREE);
+            mprVirtFree(region, region->size);
+        } else {
+            prior = region;
+        }
+    }
+}
+
+
+static void markRoots()
+{
+    MprMarkStack    *ms;
+    MprMem          *mp;
+    void            *root;
+    int             i;
+
+    heap->stats.markVisited = 0;
+    heap->stats.marked = 0;
+    heap->stats.markers = 1;
+    if (heap->markers > 0) {
+        startParallelMark();
+    }
+    mprMark(heap->roots);
+    mprMark(heap->mutex);
+    mprMark(heap->markerCond);
+    for (i = 1; i < MPR_MAX_MARKERS; i++) {
+        ms = &heap->markStacks[i];
+        mprMark(ms->thread);
+        mprMark(ms->cond);
+    }
+    heap->rootIndex = 0;
+    while ((root = getNextRoot()) != 0) {
+        checkYielded();
+        mp = GET_MEM(root);
+        if (heap->minor && (GET_GEN(mp) == heap->old || GET_GEN(mp) == heap->eternal)) {
+            /* Minor collection. Roots are always traced as they may reference young blocks via static data */
+            if (HAS_MANAGER(mp) && GET_MANAGER(mp)) {
+                (GET_MANAGER(mp))(root, MPR_MANAGE_MARK);
+            }
+        } else {
+            mprMark(root);
+        }
+    }
+    heap->rootIndex = -1;
+    if (heap->minor) {
+        markDirty();
+        markArenas();
+    }
+    if (heap->parallel) {
+        drainMarks(&heap->markStacks[0]);
+        finishParallelMark();
+    }
+    if (heap->minor) {
+        checkSuspects();
+    }
+}
+
+
+/*
+    Start a parallel mark. The current thread becomes the primary marker and the active helpers are woken.
+    When parallel, mprMarkBlock pushes blocks onto the marker's stack instead of recursing into managers.
+ */
+static int startParallelMark()
+{
+    MprThread       *tp;
+    MprMarkStack    *ms;
+    int             i;
+
+    ms = &heap->markStacks[0];
+    if (heap->activeMarkers <= 0 || (tp = mprGetCurrentThread()) == 0) {
+        return 0;
+    }
+    if (ms->items == 0 && initMarkStack(ms) < 0) {
+        return 0;
+    }
+    tp->markStack = ms;
+    heap->markIdle = 0;
+    heap->markDone = 0;
+    heap->stats.markers = heap->activeMarkers + 1;
+    mprAtomicBarrier();
+    heap->parallel = 1;
+    for (i = 1; i <= heap->activeMarkers; i++) {
+        mprSignalCond(heap->markStacks[i].cond);
+    }
+    return 1;
+}
+
+
+/*
+    Wait for all helpers to complete the current parallel mark
+ */
+static void finishParallelMark()
+{
+    MprMarkStack    *ms;
+
+    while (heap->markDone < heap->stats.markers - 1) {
+        mprNap(0);
+    }
+    for (ms = heap->markStacks; ms < &heap->markStacks[heap->stats.markers]; ms++) {
+#if BIT_MEMORY_STATS
+        heap->stats.marked += ms->marked;
+#endif
+        ms->marked = 0;
+    }
+    heap->parallel = 0;
+    mprAtomicBarrier();
+}
+
+
+/*
+    Helper marker thread main program
+ */
+static void markerHelper(MprMarkStack *ms, MprThread *tp)
+{
+    int     index;
+
+    LOG(5, "DEBUG: parallel marker thread started");
+    tp->stickyYield = 1;
+    tp->yielded = 1;
+    tp->markStack = ms;
+    index = (int) (ms - heap->markStacks);
+
+    while (!mprIsFinished()) {
+        mprWaitForCond(ms->cond, -1);
+        if (mprIsFinished()) {
+            break;
+        }
+        /* Only participate once and only if engaged for this collection. Ignore other wakeups */
+        if (heap->parallel && index < heap->stats.markers && ms->iteration != heap->iteration) {
+            ms->iteration = heap->iteration;
+            drainMarks(ms);
+            mprAtomicAdd(&heap->markDone, 1);
+        } else if (heap->sweeping) {
+            while (sweepNextRegion()) { }
+        }
+    }
+}
+
+
+static int initMarkStack(MprMarkStack *ms)
+{
+    mprInitSpinLock(&ms->lock);
+    if ((ms->items = vmalloc(MPR_MARK_STACK_SIZE * sizeof(void*), MPR_MAP_READ | MPR_MAP_WRITE)) == 0) {
+        return MPR_ERR_MEMORY;
+    }
+    ms->size = MPR_MARK_STACK_SIZE;
+    ms->top = 0;
+    return 0;
+}
+
+
+/*
+    Mark stacks grow using virtual memory as heap allocations are not permitted while marking
+ */
+static void pushMark(MprMarkStack *ms, cvoid *ptr)
+{
+    cvoid   **items;
+
+    mprSpinLock(&ms->lock);
+    if (ms->top >= ms->size) {
+        if ((items = vmalloc(ms->size * 2 * sizeof(void*), MPR_MAP_READ | MPR_MAP_WRITE)) == 0) {
+            mprSpinUnlock(&ms->lock);
+            /* Can't grow the stack so mark recursively instead */
+            (GET_MANAGER(GET_MEM(ptr)))((void*) ptr, MPR_MANAGE_MARK);
+            return;
+        }
+        memcpy(items, ms->items, ms->size * sizeof(void*));
+        vmfree((void*) ms->items, ms->size * sizeof(void*));
+        ms->items = items;
+        ms->size *= 2;
+    }
+    ms->items[ms->top++] = ptr;
+    mprSpinUnlock(&ms->lock);
+}
+
+
+static cvoid *popMark(MprMarkStack *ms)
+{
+    cvoid   *ptr;
+
+    ptr = 0;
+    mprSpinLock(&ms->lock);
+    if (ms->top > 0) {
+        ptr = ms->items[--ms->top];
+    }
+    mprSpinUnlock(&ms->lock);
+    return ptr;
+}
+
+
+/*
+    Steal up to half the work (bounded by MPR_MARK_STEAL) from the first busy marker. Returns true if work was stolen.
+ */
+static int stealMarks(MprMarkStack *ms)
+{
+    MprMarkStack    *victim;
+    cvoid           *stolen[MPR_MARK_STEAL];
+    int             i, count;
+
+    for (victim = heap->markStacks; victim < &heap->markStacks[heap->stats.markers]; victim++) {
+        if (victim == ms || victim->top == 0) {
+            continue;
+        }
+        mprSpinLock(&victim->lock);
+        count = (int) min((victim->top + 1) / 2, MPR_MARK_STEAL);
+        for (i = 0; i < count; i++) {
+            stolen[i] = victim->items[--victim->top];
+        }
+        mprSpinUnlock(&victim->lock);
+        if (count > 0) {
+            for (i = 0; i < count; i++) {
+                pushMark(ms, stolen[i]);
+            }
+            mprAtomicAdd64((int64*) &heap->stats.markSteals, 1);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+static int hasMarkWork()
+{
+    MprMarkStack    *ms;
+
+    for (ms = heap->markStacks; ms < &heap->markStacks[heap->stats.markers]; ms++) {
+        if (ms->top > 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/*
+    Run managers for blocks on the mark stack until all markers are out of work. Termination is detected when all 
+    participating markers are idle (an idle marker has an empty stack and only a busy marker can push work).
+ */
+static void drainMarks(MprMarkStack *ms)
+{
+    cvoid   *ptr;
+
+    while (1) {
+        while ((ptr = popMark(ms)) != 0) {
+            (GET_MANAGER(GET_MEM(ptr)))((void*) ptr, MPR_MANAGE_MARK);
+        }
+        if (stealMarks(ms)) {
+            continue;
+        }
+        mprAtomicAdd(&heap->markIdle, 1);
+        while (heap->markIdle < heap->stats.markers) {
+            if (hasMarkWork()) {
+                break;
+            }
+            mprNap(0);
+        }
+        if (heap->markIdle >= heap->stats.markers) {
+            break;
+        }
+        mprAtomicAdd(&heap->markIdle, -1);
+    }
+}
+
+
+static MprMarkStack *getMarkStack()
+{
+    MprThread   *tp;
+
+    if ((tp = mprGetThreadData(MPR->threadService->local)) == 0) {
+        return 0;
+    }
+    return tp->markStack;
+}
+
+
+/*
+    Mark a block when marking in parallel. The mark is set atomically so only one marker will run the block's manager.
+ */
+static void markParallel(MprMarkStack *ms, cvoid *ptr, MprMem *mp)
+{
+    size_t      field2, update;
+    int         gen;
+
+    do {
+        field2 = mp->field2;
+        if ((int) (field2 & MPR_MASK_MARK) == heap->active) {
+            return;
+        }
+        gen = (int) ((field2 & MPR_MASK_GEN) >> MPR_SHIFT_GEN);
+        if (gen != heap->eternal) {
+            gen = heap->active;
+        }
+        update = (field2 & MPR_MASK_SIZE) | (((size_t) gen) << MPR_SHIFT_GEN) | ((size_t) heap->active << MPR_SHIFT_MARK);
+    } while (!mprAtomicCas((void**) &mp->field2, (void*) field2, (void*) update));
+
+    /* Counted per-marker and summed by finishParallelMark() */
+    ms->marked++;
+    if (HAS_MANAGER(mp)) {
+        pushMark(ms, ptr);
+    }
+}
+
+
+void mprMarkBlock(cvoid *ptr)
+{
+    MprMem          *mp;
+    MprMarkStack    *ms;
+    int             gen;
+#if BIT_DEBUG
+    static int  depth = 0;
+#endif
+
+    if (ptr == 0) {
+        return;
+    }
+    mp = MPR_GET_MEM(ptr);
+#if BIT_DEBUG
+    if (!mprIsValid(ptr)) {
+        mprError("Memory block is either not dynamically allocated, or is corrupted");
+        return;
+    }
+    mprAssert(!IS_FREE(mp));
+#if PARALLEL_GC
+    mprAssert(GET_MARK(mp) != heap->dead);
+    mprAssert(GET_GEN(mp) != heap->dead);
+    if (GET_MARK(mp) == heap->dead || IS_FREE(mp)) {
+        mprAssert(0);
+        return;
+    }
+#endif
+#endif
+    CHECK(mp);
+    INC(markVisited);
+    if (heap->minor) {
+        gen = GET_GEN(mp);
+        if (gen == heap->old || gen == heap->eternal) {
+            /* Minor collection. Old blocks are only traced if modified. See markDirty() */
+            return;
+        }
+    }
+    mprAssert((GET_MARK(mp) != heap->active) || GET_GEN(mp) == heap->active);
+
+    if (GET_MARK(mp) != heap->active) {
+        BREAKPOINT(mp);
+        if (heap->parallel && (ms = getMarkStack()) != 0) {
+            markParallel(ms, ptr, mp);
+            return;
+        }
+        INC(marked);
+        gen = GET_GEN(mp);
+        if (gen != heap->eternal) {
+            gen = heap->active;
+        }
+        /* Lock-free update */
+        SET_FIELD2(mp, GET_SIZE(mp), gen, heap->active, 0);
+        if (HAS_MANAGER(mp)) {
+#if BIT_DEBUG
+            if (++depth > 400) {
+                fprintf(stderr, "WARNING: Possibly too much recursion. Marking depth exceeds 400\n");
+                mprBreakpoint();
+            }
+#endif
+            (GET_MANAGER(mp))((void*) ptr, MPR_MANAGE_MARK);
+#if BIT_DEBUG
+            --depth;
+#endif
+        }
+    }
+}
+
+
+/*
+    Prepare for a minor collection. Build a map of young blocks for conservative scanning and a list of old blocks on 
+    pages modified since the last collection. Must be called while threads are paused and before marking.
+ */
+static int prepareMinor()
+{
+    MprNursery          *np;
+    MprNurseryRegion    *nr;
+    MprRegion           *region;
+    MprMem              *mp;
+    ssize               bits, bit, words;
+    int                 count, gen, allDirty, i;
+
+    np = heap->nurseryState;
+    for (count = 0, bits = 0, region = heap->regions; region; region = region->next) {
+        count++;
+        bits += region->size / MPR_ALIGN;
+    }
+    words = (bits + SLAB_BITS - 1) / SLAB_BITS;
+    if (growTable((void**) &np->regions, &np->regionMax, count, sizeof(MprNurseryRegion)) < 0 ||
+            growTable((void**) &np->young, &np->youngMax, words, sizeof(ulong)) < 0) {
+        return MPR_ERR_MEMORY;
+    }
+    memset(np->young, 0, words * sizeof(ulong));
+    np->regionCount = 0;
+    np->dirtyCount = 0;
+    np->scanCount = 0;
+    np->suspectCount = 0;
+
+    for (bits = 0, region = heap->regions; region; region = region->next) {
+        nr = &np->regions[np->regionCount++];
+        nr->start = (char*) region;
+        nr->end = (char*) region + region->size;
+        nr->base = bits;
+        bits += region->size / MPR_ALIGN;
+        allDirty = !heap->softDirty || readDirtyPages(region) < 0;
+
+        for (i = 0, mp = region->start; mp; ) {
+            if (!IS_FREE(mp)) {
+                gen = GET_GEN(mp);
+                if (gen == heap->old || gen == heap->eternal) {
+                    if (isDirty(region, mp, allDirty)) {
+                        if (growTable((void**) &np->dirty, &np->dirtyMax, np->dirtyCount + 1, sizeof(MprMem*)) < 0) {
+                            return MPR_ERR_MEMORY;
+                        }
+                        np->dirty[np->dirtyCount++] = mp;
+                    }
+                } else {
+                    bit = nr->base + ((char*) mp - nr->start) / MPR_ALIGN;
+                    np->young[bit / SLAB_BITS] |= ((ulong) 1) << (bit % SLAB_BITS);
+                }
+            }
+            if (region->slabMap) {
+                mp = (++i < region->slabCount) ? (MprMem*) (((char*) region->start) + (i * region->slabSize)) : 0;
+            } else {
+                mp = GET_NEXT(mp);
+            }
+        }
+    }
+    qsort(np->regions, np->regionCount, sizeof(MprNurseryRegion), compareRegions);
+    return 0;
+}
+
+
+/*
+    Trace old blocks that were modified since the last collection. Blocks with managers are traced precisely. 
+    Other blocks (lists, hash buckets, keys) are scanned conservatively for references to young blocks.
+ */
+static void markDirty()
+{
+    MprNursery  *np;
+    MprMem      *mp;
+    ssize       i;
+
+    np = heap->nurseryState;
+    for (i = 0; i < np->dirtyCount; i++) {
+        mp = np->dirty[i];
+        if (HAS_MANAGER(mp)) {
+            if (GET_MANAGER(mp)) {
+                (GET_MANAGER(mp))(GET_PTR(mp), MPR_MANAGE_MARK);
+            }
+        } else {
+            scanBlock(mp);
+        }
+        while (np->scanCount > 0) {
+            scanBlock(np->scan[--np->scanCount]);
+        }
+    }
+    heap->gcStats.lastDirty = np->dirtyCount;
+}
+
+
+/*
+    Trace the managed blocks of all live arenas. Modifications to arena blocks are not tracked as arena chunks are 
+    not part of the heap regions, so arena blocks may reference young blocks regardless of the dirty state of the arena.
+ */
+static void markArenas()
+{
+    MprArena    *arena;
+
+    lockHeap();
+    for (arena = heap->arenas; arena; arena = arena->nextArena) {
+        manageArenaBlocks(arena, MPR_MANAGE_MARK);
+    }
+    unlockHeap();
+}
+
+
+/*
+    Conservatively scan a block without a manager for references to young blocks. Young blocks without managers that 
+    are found are marked and queued to be scanned in turn. A conservative reference may be stale, so the managers of
+    young blocks found this way are never run. Rather, the blocks are checked after marking. See checkSuspects().
+ */
+static void scanBlock(MprMem *mp)
+{
+    MprNursery  *np;
+    MprMem      *bp;
+    void        **ptr, **end;
+
+    np = heap->nurseryState;
+    end = (void**) (((char*) mp) + GET_SIZE(mp));
+    for (ptr = (void**) GET_PTR(mp); ptr < end; ptr++) {
+        if (*ptr == 0 || !isYoung(*ptr)) {
+            continue;
+        }
+        bp = GET_MEM(*ptr);
+        if (GET_MARK(bp) == heap->active) {
+            continue;
+        }
+        if (HAS_MANAGER(bp)) {
+            if (growTable((void**) &np->suspects, &np->suspectMax, np->suspectCount + 1, sizeof(MprMem*)) < 0) {
+                heap->retainYoung = 1;
+            } else {
+                np->suspects[np->suspectCount++] = bp;
+            }
+        } else {
+            mprMarkBlock(*ptr);
+            if (growTable((void**) &np->scan, &np->scanMax, np->scanCount + 1, sizeof(MprMem*)) < 0) {
+                scanBlock(bp);
+            } else {
+                np->scan[np->scanCount++] = bp;
+            }
+        }
+    }
+}
+
+
+/*
+    Check the managed young blocks found by conservative scanning. If any were not marked precisely, they may still be 
+    referenced and their references can't be traced. In that case, retain all young blocks in this collection and make
+    the next collection a full collection.
+ */
+static void checkSuspects()
+{
+    MprNursery  *np;
+    ssize       i;
+
+    np = heap->nurseryState;
+    for (i = 0; i < np->suspectCount && !heap->retainYoung; i++) {
+        if (GET_MARK(np->suspects[i]) != heap->active) {
+            heap->retainYoung = 1;
+        }
+    }
+    if (heap->retainYoung) {
+        heap->needFull = 1;
+        heap->gcStats.minorRetains++;
+    }
+}
+
+
+/*
+    Test if a pointer is the start of a young block. Uses the map built by prepareMinor().
+ */
+static int isYoung(cvoid *ptr)
+{
+    MprNursery          *np;
+    MprNurseryRegion    *nr;
+    char                *mp;
+    ssize               bit;
+    int                 low, high, mid;
+
+    if (((size_t) ptr) & (MPR_ALIGN - 1)) {
+        return 0;
+    }
+    np = heap->nurseryState;
+    mp = (char*) GET_MEM(ptr);
+    low = 0;
+    high = np->regionCount - 1;
+    while (low <= high) {
+        mid = (low + high) / 2;
+        nr = &np->regions[mid];
+        if (mp < nr->start) {
+            high = mid - 1;
+        } else if (mp >= nr->end) {
+            low = mid + 1;
         } else {
-            prior = region;
+            bit = nr->base + (mp - nr->start) / MPR_ALIGN;
+            return (int) ((np->young[bit / SLAB_BITS] >> (bit % SLAB_BITS)) & 1);
         }
     }
+    return 0;
 }
 
 
-static void markRoots()
+static int compareRegions(cvoid *p1, cvoid *p2)
 {
-    void    *root;
+    MprNurseryRegion    *r1, *r2;
 
-    heap->stats.markVisited = 0;
-    heap->stats.marked = 0;
-    mprMark(heap->roots);
-    mprMark(heap->mutex);
-    mprMark(heap->markerCond);
+    r1 = (MprNurseryRegion*) p1;
+    r2 = (MprNurseryRegion*) p2;
+    return (r1->start < r2->start) ? -1 : ((r1->start > r2->start) ? 1 : 0);
+}
 
-    heap->rootIndex = 0;
-    while ((root = getNextRoot()) != 0) {
-        checkYielded();
-        mprMark(root);
+
+/*
+    Promote a surviving block to the old generation and reset its mark for the next collection
+ */
+static void promoteBlock(MprMem *mp)
+{
+    int     gen;
+
+    gen = GET_GEN(mp);
+    if (gen != heap->eternal) {
+        gen = heap->old;
+    }
+    if (GET_GEN(mp) != gen || GET_MARK(mp) != UNMARKED) {
+        SET_FIELD2(mp, GET_SIZE(mp), gen, UNMARKED, 0);
     }
-    heap->rootIndex = -1;
 }
 
 
-void mprMarkBlock(cvoid *ptr)
+/*
+    Grow a table allocated from virtual memory. Existing entries are preserved.
+ */
+static int growTable(void **table, ssize *max, ssize need, ssize size)
 {
-    MprMem      *mp;
-    int         gen;
-#if BIT_DEBUG
-    static int  depth = 0;
-#endif
+    void    *ptr;
+    ssize   count;
 
-    if (ptr == 0) {
-        return;
+    if (need <= *max) {
+        return 0;
     }
-    mp = MPR_GET_MEM(ptr);
-#if BIT_DEBUG
-    if (!mprIsValid(ptr)) {
-        mprError("Memory block is either not dynamically allocated, or is corrupted");
-        return;
+    count = max(need * 2, 1024);
+    if ((ptr = vmalloc(MPR_PAGE_ALIGN(count * size, memStats.pageSize), MPR_MAP_READ | MPR_MAP_WRITE)) == 0) {
+        return MPR_ERR_MEMORY;
     }
-    mprAssert(!IS_FREE(mp));
-#if PARALLEL_GC
-    mprAssert(GET_MARK(mp) != heap->dead);
-    mprAssert(GET_GEN(mp) != heap->dead);
-    if (GET_MARK(mp) == heap->dead || IS_FREE(mp)) {
-        mprAssert(0);
-        return;
+    if (*table) {
+        memcpy(ptr, *table, *max * size);
+        vmfree(*table, MPR_PAGE_ALIGN(*max * size, memStats.pageSize));
     }
+    *table = ptr;
+    *max = count;
+    return 0;
+}
+
+
+/*
+    O/S dirty page tracking. Linux sets a "soft-dirty" bit (bit 55 of the /proc/self/pagemap entry) when a page is 
+    written. The bits are cleared by writing "4" to /proc/self/clear_refs.
+ */
+#define PAGEMAP_SOFT_DIRTY  (((uint64) 1) << 55)
+
+/*
+    Read the page map entries for a region
+ */
+static int readDirtyPages(MprRegion *region)
+{
+#if LINUX
+    MprNursery  *np;
+    ssize       count, len;
+
+    np = heap->nurseryState;
+    count = region->size / memStats.pageSize;
+    if (growTable((void**) &np->pages, &np->pageMax, count, sizeof(uint64)) < 0) {
+        return MPR_ERR_MEMORY;
+    }
+    len = count * sizeof(uint64);
+    if (pread(heap->pagemap, np->pages, len, (off_t) (((size_t) region) / memStats.pageSize) * sizeof(uint64)) != len) {
+        return MPR_ERR_CANT_READ;
+    }
+    return 0;
+#else
+    return MPR_ERR_BAD_STATE;
 #endif
-#endif
-    CHECK(mp);
-    INC(markVisited);
-    mprAssert((GET_MARK(mp) != heap->active) || GET_GEN(mp) == heap->active);
+}
 
-    if (GET_MARK(mp) != heap->active) {
-        BREAKPOINT(mp);
-        INC(marked);
-        gen = GET_GEN(mp);
-        if (gen != heap->eternal) {
-            gen = heap->active;
+
+/*
+    Test if any page of a block was written since the last collection
+ */
+static int isDirty(MprRegion *region, MprMem *mp, int allDirty)
+{
+    ssize   first, last, i;
+
+    if (allDirty) {
+        return 1;
+    }
+    first = ((char*) mp - (char*) region) / memStats.pageSize;
+    last = ((char*) mp + GET_SIZE(mp) - 1 - (char*) region) / memStats.pageSize;
+    for (i = first; i <= last; i++) {
+        if (heap->nurseryState->pages[i] & PAGEMAP_SOFT_DIRTY) {
+            return 1;
         }
-        /* Lock-free update */
-        SET_FIELD2(mp, GET_SIZE(mp), gen, heap->active, 0);
-        if (HAS_MANAGER(mp)) {
-#if BIT_DEBUG
-            if (++depth > 400) {
-                fprintf(stderr, "WARNING: Possibly too much recursion. Marking depth exceeds 400\n");
-                mprBreakpoint();
-            }
-#endif
-            (GET_MANAGER(mp))((void*) ptr, MPR_MANAGE_MARK);
-#if BIT_DEBUG
-            --depth;
+    }
+    return 0;
+}
+
+
+static void clearDirtyPages()
+{
+#if LINUX
+    if (write(heap->clearRefs, "4", 1) != 1) {
+        heap->softDirty = 0;
+    }
 #endif
+}
+
+
+/*
+    Test if soft-dirty page tracking works by writing a page and checking its soft-dirty bit before and after clearing
+ */
+static int checkSoftDirty()
+{
+#if LINUX
+    uint64  entry;
+    off_t   offset;
+    char    *page;
+    int     dirty, clean;
+
+    if ((heap->pagemap = open("/proc/self/pagemap", O_RDONLY)) < 0) {
+        return 0;
+    }
+    if ((heap->clearRefs = open("/proc/self/clear_refs", O_WRONLY)) < 0) {
+        close(heap->pagemap);
+        return 0;
+    }
+    dirty = clean = 0;
+    if ((page = vmalloc(memStats.pageSize, MPR_MAP_READ | MPR_MAP_WRITE)) != 0) {
+        offset = (off_t) (((size_t) page) / memStats.pageSize) * sizeof(uint64);
+        page[0] = 1;
+        if (write(heap->clearRefs, "4", 1) == 1 && pread(heap->pagemap, &entry, sizeof(entry), offset) == sizeof(entry)) {
+            clean = !(entry & PAGEMAP_SOFT_DIRTY);
+            page[0] = 2;
+            if (pread(heap->pagemap, &entry, sizeof(entry), offset) == sizeof(entry)) {
+                dirty = (entry & PAGEMAP_SOFT_DIRTY) ? 1 : 0;
+            }
         }
+        vmfree(page, memStats.pageSize);
+    }
+    if (!(dirty && clean)) {
+        close(heap->pagemap);
+        close(heap->clearRefs);
+        return 0;
     }
+    return 1;
+#else
+    return 0;
+#endif
 }
 
 
@@ -1316,8 +3051,11 @@ void mprRelease(void *ptr)
         mp = GET_MEM(ptr);
         if (VALID_BLK(mp)) {
             mprAssert(!IS_FREE(mp));
-            /* Lock-free update of mp->gen */
-            SET_FIELD2(mp, GET_SIZE(mp), heap->active, UNMARKED, 0);
+            /* 
+                Lock-free update of mp->gen. With the nursery, the block may be referenced from unmodified old blocks
+                so it must not become young again. Test promote rather than nursery as sweeping is never lazy then.
+             */
+            SET_FIELD2(mp, GET_SIZE(mp), heap->promote ? heap->old : heap->active, UNMARKED, 0);
         }
     }
 }
@@ -1393,6 +3131,7 @@ void mprYield(int flags)
 {
     MprThreadService    *ts;
     MprThread           *tp;
+    MprTime             start;
 
     ts = MPR->threadService;
     if ((tp = mprGetCurrentThread()) == 0) {
@@ -1408,13 +3147,21 @@ void mprYield(int flags)
         tp->stickyYield = 1;
     }
     mprAssert(tp->yielded);
+    start = 0;
     while (tp->yielded && (heap->mustYield || (flags & MPR_YIELD_BLOCK)) && heap->marker) {
+        if (start == 0) {
+            start = mprGetTime();
+        }
         if (heap->flags & MPR_MARK_THREAD) {
             mprSignalCond(ts->cond);
         }
         mprWaitForCond(tp->cond, -1);
         flags &= ~MPR_YIELD_BLOCK;
     }
+    if (start) {
+        tp->yieldWait += mprGetTime() - start;
+        tp->yieldWaits++;
+    }
     if (!tp->stickyYield) {
         tp->yielded = 0;
     }
@@ -1555,6 +3302,7 @@ void mprVerifyMem()
         }
     }
     for (i = 0, freeq = heap->freeq; freeq != heap->freeEnd; freeq++, i++) {
+        lockQueue(i);
         for (fp = freeq->next; fp != freeq; fp = fp->next) {
             mp = (MprMem*) fp;
             CHECK(mp);
@@ -1578,6 +3326,7 @@ void mprVerifyMem()
             }
 #endif
         }
+        unlockQueue(i);
     }
     unlockHeap();
 #endif
@@ -1593,7 +3342,7 @@ int mprIsDead(cvoid *ptr)
 
     mp = GET_MEM(ptr);
     if (VALID_BLK(mp)) {
-        return GET_GEN(mp) == heap->dead;
+        return IS_DEAD(mp);
     }
     return 0;
 }
@@ -1626,6 +3375,7 @@ bool mprEnableGC(bool on)
 static void initGen()
 {
     heap->eternal = MPR_GEN_ETERNAL;
+    heap->old = MPR_GEN_OLD;
     heap->active = heap->eternal - 1;
 #if PARALLEL_GC
     heap->stale = heap->active - 1;
@@ -1697,6 +3447,232 @@ static void *getNextRoot()
 }
 
 
+/********************************************************* Profiler *******************************************************/
+
+int mprStartMemProfile(ssize interval)
+{
+    MprMemProfile   *pp;
+    ssize           size;
+
+    if (interval <= 0) {
+        interval = MPR_MEM_PROFILE_INTERVAL;
+    }
+    mprLock(heap->mutex);
+    if ((pp = heap->profile) == 0) {
+        size = sizeof(MprMemProfile) + (MPR_MEM_PROFILE_SITES * sizeof(MprMemSite)) + 
+            (MPR_MEM_PROFILE_SAMPLES * sizeof(MprMemSample));
+        size = MPR_PAGE_ALIGN(size, memStats.pageSize);
+        if ((pp = vmalloc(size, MPR_MAP_READ | MPR_MAP_WRITE)) == 0) {
+            mprUnlock(heap->mutex);
+            return MPR_ERR_MEMORY;
+        }
+        memset(pp, 0, size);
+        pp->sites = (MprMemSite*) &pp[1];
+        pp->samples = (MprMemSample*) &pp->sites[MPR_MEM_PROFILE_SITES];
+        mprInitSpinLock(&pp->lock);
+        heap->profile = pp;
+    }
+    pp->interval = interval;
+    pp->sampleBytes = interval;
+    mprAtomicBarrier();
+    heap->profiling = 1;
+    mprUnlock(heap->mutex);
+    return 0;
+}
+
+
+void mprStopMemProfile()
+{
+    heap->profiling = 0;
+}
+
+
+/*
+    Account for an allocation and sample it if the thread has allocated an interval of bytes since its last sample
+ */
+static void sampleAlloc(MprMem *mp, ssize size)
+{
+    MprMemProfile   *pp;
+    MprMemCache     *cache;
+    ssize           *remaining;
+
+    if ((pp = heap->profile) == 0) {
+        return;
+    }
+    if ((cache = getCache()) != 0) {
+        remaining = &cache->sampleBytes;
+    } else {
+        /* RACE: foreign threads share a counter. Only the sample rate is affected */
+        remaining = &pp->sampleBytes;
+    }
+    if ((*remaining -= size) > 0) {
+        return;
+    }
+    *remaining = pp->interval;
+    recordSample(pp, mp, max(size, pp->interval));
+}
+
+
+/*
+    Record the allocation stack for a sampled block. The stack includes the allocator frames leading to this function.
+ */
+static void recordSample(MprMemProfile *pp, MprMem *mp, ssize weight)
+{
+    MprMemSite      *sp;
+    MprMemSample    *sample;
+    void            *frames[MPR_MEM_PROFILE_DEPTH + 1];
+    uint            hash;
+    int             depth, i, index;
+
+#if HAS_BACKTRACE
+    /* Skip this function's frame */
+    depth = max(backtrace(frames, MPR_MEM_PROFILE_DEPTH + 1) - 1, 0);
+#else
+    depth = 0;
+#endif
+    for (hash = 0, i = 1; i <= depth; i++) {
+        hash = (hash * 33) + (uint) (((size_t) frames[i]) >> 2);
+    }
+    mprSpinLock(&pp->lock);
+    pp->taken++;
+    for (index = hash % MPR_MEM_PROFILE_SITES, i = 0; i < MPR_MEM_PROFILE_SITES; i++) {
+        sp = &pp->sites[index];
+        if (!sp->used) {
+            if (pp->siteCount >= (MPR_MEM_PROFILE_SITES / 4 * 3)) {
+                sp = 0;
+            } else {
+                sp->used = 1;
+                sp->hash = hash;
+                sp->depth = depth;
+                memcpy(sp->frames, &frames[1], depth * sizeof(void*));
+                pp->siteCount++;
+            }
+            break;
+        }
+        if (sp->hash == hash && sp->depth == depth && memcmp(sp->frames, &frames[1], depth * sizeof(void*)) == 0) {
+            break;
+        }
+        index = (index + 1) % MPR_MEM_PROFILE_SITES;
+    }
+    if (sp == 0 || pp->sampleCount >= MPR_MEM_PROFILE_SAMPLES) {
+        pp->dropped++;
+    } else {
+        sample = &pp->samples[pp->sampleCount++];
+        sample->mp = mp;
+        sample->site = index;
+        sample->weight = weight;
+        sp->allocated += weight;
+        sp->live += weight;
+        sp->count++;
+    }
+    mprSpinUnlock(&pp->lock);
+}
+
+
+/*
+    Remove samples for blocks that are about to be freed. Must be called by the sweeper while threads are paused.
+ */
+static void pruneProfile()
+{
+    MprMemProfile   *pp;
+    MprMemSample    *sample, *to, *end;
+    MprMemSite      *sp;
+
+    if ((pp = heap->profile) == 0) {
+        return;
+    }
+    mprSpinLock(&pp->lock);
+    end = &pp->samples[pp->sampleCount];
+    for (to = sample = pp->samples; sample < end; sample++) {
+        if (IS_DEAD(sample->mp)) {
+            sp = &pp->sites[sample->site];
+            sp->live -= sample->weight;
+            sp->count--;
+        } else {
+            *to++ = *sample;
+        }
+    }
+    pp->sampleCount = (int) (to - pp->samples);
+    mprSpinUnlock(&pp->lock);
+}
+
+
+/*
+    Format a stack frame symbol for a collapsed stack. Uses the function name if available, otherwise the address.
+ */
+static char *frameName(cchar *symbol, void *frame)
+{
+    cchar   *start, *end;
+
+    /* Glibc format: "module(function+offset) [address]" */
+    if (symbol && (start = strchr(symbol, '(')) != 0 && *++start != '+' && *start != ')') {
+        if ((end = strpbrk(start, "+)")) != 0) {
+            return snclone(start, end - start);
+        }
+    }
+    return sfmt("%p", frame);
+}
+
+
+int mprDumpMemProfile(cchar *path)
+{
+    MprMemProfile   *pp;
+    MprMemSite      *sites, *sp;
+    MprFile         *file;
+    MprBuf          *buf;
+    char            **symbols;
+    int             count, i, j, limit;
+
+    if ((pp = heap->profile) == 0) {
+        return MPR_ERR_BAD_STATE;
+    }
+    /*
+        Take a snapshot of the sites so that formatting (which allocates) is not done while locked
+     */
+    limit = pp->siteCount;
+    if ((sites = mprAlloc(max(limit, 1) * sizeof(MprMemSite))) == 0) {
+        return MPR_ERR_MEMORY;
+    }
+    mprSpinLock(&pp->lock);
+    for (count = i = 0; i < MPR_MEM_PROFILE_SITES && count < limit; i++) {
+        if (pp->sites[i].used && pp->sites[i].live > 0) {
+            sites[count++] = pp->sites[i];
+        }
+    }
+    mprSpinUnlock(&pp->lock);
+
+    buf = mprCreateBuf(0, 0);
+    for (i = 0; i < count; i++) {
+        sp = &sites[i];
+#if HAS_BACKTRACE
+        symbols = backtrace_symbols(sp->frames, sp->depth);
+#else
+        symbols = 0;
+#endif
+        if (sp->depth == 0) {
+            mprPutStringToBuf(buf, "[unknown]");
+        }
+        for (j = sp->depth - 1; j >= 0; j--) {
+            mprPutStringToBuf(buf, frameName(symbols ? symbols[j] : 0, sp->frames[j]));
+            if (j > 0) {
+                mprPutCharToBuf(buf, ';');
+            }
+        }
+        mprPutFmtToBuf(buf, " %Ld\n", (int64) sp->live);
+        free(symbols);
+    }
+    if ((file = mprOpenFile(path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644)) == 0) {
+        return MPR_ERR_CANT_OPEN;
+    }
+    if (mprWriteFile(file, mprGetBufStart(buf), mprGetBufLength(buf)) != mprGetBufLength(buf)) {
+        mprCloseFile(file);
+        return MPR_ERR_CANT_WRITE;
+    }
+    mprCloseFile(file);
+    return count;
+}
+
+
 /****************************************************** Debug *************************************************************/
 
 #if BIT_MEMORY_STATS
@@ -1827,6 +3803,20 @@ void mprPrintMem(cchar *msg, int detail)
     printf("  Block reuse         %14d %%\n",            percent(ap->reuse, ap->requests));
     printf("  Joins               %14d %%\n",            percent(ap->joins, ap->requests));
     printf("  Splits              %14d %%\n",            percent(ap->splits, ap->requests));
+    printf("  Thread cache hits   %14d %%\n",            percent(ap->cacheHits, ap->requests));
+    printf("  Thread cache refills%14d\n",               (int) ap->cacheRefills);
+    printf("  Thread cache bytes  %14d K\n",             (int) (ap->cached / 1024));
+    printf("  GC markers          %14d\n",               ap->markers);
+    printf("  GC pause            %14d msec\n",          (int) heap->gcStats.lastPause);
+    printf("  GC max pause        %14d msec\n",          (int) heap->gcStats.maxPause);
+    printf("  GC pause budget     %14d msec\n",          (int) ap->pauseBudget);
+    printf("  GC pause overruns   %14d\n",               (int) ap->pauseOverruns);
+    printf("  GC mark steals      %14d\n",               (int) ap->markSteals);
+    printf("  GC lazy sweeps      %14d\n",               (int) ap->lazySweeps);
+    printf("  Slab regions        %14d\n",               ap->slabs);
+    printf("  Slab allocations    %14d %%\n",            percent(ap->slabAllocs, ap->requests));
+    printf("  Region releases     %14d\n",               (int) ap->releases);
+    printf("  Lock contention     %14d\n",               (int) ap->contention);
 
     printGCStats();
     if (detail) {
@@ -2170,10 +4160,100 @@ MprMemStats *mprGetMemStats()
     heap->stats.user = usermem;
 #endif
     heap->stats.rss = mprGetMem();
+    heap->stats.cacheHits = getCacheHits();
     return &heap->stats;
 }
 
 
+MprGCStats *mprGetGCStats()
+{
+    return &heap->gcStats;
+}
+
+
+MprHash *mprGetGCStatsObj()
+{
+    MprThreadService    *ts;
+    MprThread           *tp;
+    MprGCStats          *gs;
+    MprHash             *obj, *list, *item;
+    char                key[32];
+    int                 i;
+
+    gs = &heap->gcStats;
+    obj = mprCreateHash(0, 0);
+    mprSetJsonNumber(obj, "cycles", gs->cycles);
+    mprSetJsonNumber(obj, "lastPause", gs->lastPause);
+    mprSetJsonNumber(obj, "maxPause", gs->maxPause);
+    mprSetJsonNumber(obj, "totalPause", gs->totalPause);
+    mprSetJsonNumber(obj, "lastSync", gs->lastSync);
+    mprSetJsonNumber(obj, "totalSync", gs->totalSync);
+    mprSetJsonNumber(obj, "lastMark", gs->lastMark);
+    mprSetJsonNumber(obj, "totalMark", gs->totalMark);
+    mprSetJsonNumber(obj, "lastSweep", gs->lastSweep);
+    mprSetJsonNumber(obj, "totalSweep", gs->totalSweep);
+    mprSetJsonNumber(obj, "lastReclaimed", gs->lastReclaimed);
+    mprSetJsonNumber(obj, "totalReclaimed", gs->totalReclaimed);
+    mprSetJsonNumber(obj, "growths", gs->growths);
+    mprSetJsonNumber(obj, "lastGrowth", gs->lastGrowth);
+    mprSetJsonNumber(obj, "lastGrowthTime", gs->lastGrowthTime);
+    mprSetJsonNumber(obj, "minorCycles", gs->minorCycles);
+    mprSetJsonNumber(obj, "lastDirty", gs->lastDirty);
+    mprSetJsonNumber(obj, "minorRetains", gs->minorRetains);
+    mprSetJsonNumber(obj, "heapSize", heap->stats.bytesAllocated);
+    mprSetJsonNumber(obj, "heapFree", heap->stats.bytesFree);
+
+    list = mprCreateHash(0, MPR_HASH_LIST);
+    for (i = 0; i < MPR_GC_PAUSE_BUCKETS; i++) {
+        itosbuf(key, sizeof(key), i, 10);
+        mprSetJsonNumber(list, key, gs->pauseHistogram[i]);
+    }
+    mprSetJsonObj(obj, "pauseHistogram", list, MPR_JSON_ARRAY);
+
+    list = mprCreateHash(0, MPR_HASH_LIST);
+    if ((ts = MPR->threadService) != 0 && ts->threads) {
+        lock(ts->threads);
+        for (i = 0; i < ts->threads->length; i++) {
+            tp = (MprThread*) mprGetItem(ts->threads, i);
+            item = mprCreateHash(0, 0);
+            mprAddKey(item, "name", tp->name);
+            mprSetJsonNumber(item, "yieldWait", tp->yieldWait);
+            mprSetJsonNumber(item, "yieldWaits", tp->yieldWaits);
+            itosbuf(key, sizeof(key), i, 10);
+            mprSetJsonObj(list, key, item, MPR_JSON_OBJ);
+        }
+        unlock(ts->threads);
+    }
+    mprSetJsonObj(obj, "threads", list, MPR_JSON_ARRAY);
+    return obj;
+}
+
+
+/*
+    Total cache hits for exited threads and all current threads
+ */
+static uint64 getCacheHits()
+{
+    MprThreadService    *ts;
+    MprThread           *tp;
+    uint64              hits;
+    int                 i;
+
+    lockHeap();
+    hits = heap->cacheHits;
+    unlockHeap();
+    if ((ts = MPR->threadService) != 0 && ts->threads) {
+        lock(ts->threads);
+        for (i = 0; i < ts->threads->length; i++) {
+            tp = (MprThread*) mprGetItem(ts->threads, i);
+            hits += tp->cache.hits;
+        }
+        unlock(ts->threads);
+    }
+    return hits;
+}
+
+
 /*
     Return the amount of memory currently in use. This routine may open files and thus is not very quick on some 
     platforms. On FREEBDS it returns the peak resident set size using getrusage. If a suitable O/S API is not available,
@@ -2366,6 +4446,13 @@ void mprSetMemPolicy(int policy)
 }
 
 
+void mprSetMemPlacement(int flags)
+{
+    heap->hugeChunkSize = max(heap->chunkSize, MPR_HUGE_PAGE_SIZE);
+    heap->placement = flags;
+}
+
+
 void mprSetMemError()
 {
     heap->hasError = 1;
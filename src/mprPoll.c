@@ -281,12 +281,10 @@ static void serviceIO(MprWaitService *ws, struct pollfd *fds, int count)
     Wake the wait service. WARNING: This routine must not require locking. MprEvents in scheduleDispatcher depends on this.
     Must be async-safe.
  */
-void mprWakeNotifier()
+void mprWakeWaitService(MprWaitService *ws)
 {
-    MprWaitService  *ws;
     int             c;
 
-    ws = MPR->waitService;
     if (!ws->wakeRequested) {
         ws->wakeRequested = 1;
         c = 0;
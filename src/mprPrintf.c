@@ -102,6 +102,7 @@ typedef struct Format {
     uchar   *end;
     ssize   growBy;
     ssize   maxsize;
+    MprArena *arena;
     int     precision;
     int     radix;
     int     width;
@@ -157,7 +158,7 @@ typedef struct MprEjsName {
 
 static int  getState(char c, int state);
 static int  growBuf(Format *fmt);
-static char *sprintfCore(char *buf, ssize maxsize, cchar *fmt, va_list arg);
+static char *sprintfCore(MprArena *arena, char *buf, ssize maxsize, cchar *fmt, va_list arg);
 static void outNum(Format *fmt, cchar *prefix, uint64 val);
 static void outString(Format *fmt, cchar *str, ssize len);
 #if BIT_CHAR_LEN > 1
@@ -243,7 +244,7 @@ int mprStaticPrintf(cchar *fmt, ...)
     fs = mprLookupFileSystem(NULL, "/");
 
     va_start(ap, fmt);
-    sprintfCore(buf, MPR_MAX_STRING, fmt, ap);
+    sprintfCore(NULL, buf, MPR_MAX_STRING, fmt, ap);
     va_end(ap);
     return mprWriteFile(fs->stdOutput, buf, slen(buf));
 }
@@ -261,7 +262,7 @@ int mprStaticPrintfError(cchar *fmt, ...)
     fs = mprLookupFileSystem(NULL, "/");
 
     va_start(ap, fmt);
-    sprintfCore(buf, MPR_MAX_STRING, fmt, ap);
+    sprintfCore(NULL, buf, MPR_MAX_STRING, fmt, ap);
     va_end(ap);
     return mprWriteFile(fs->stdError, buf, slen(buf));
 }
@@ -278,7 +279,7 @@ char *mprSprintf(char *buf, ssize bufsize, cchar *fmt, ...)
     mprAssert(bufsize > 0);
 
     va_start(ap, fmt);
-    result = sprintfCore(buf, bufsize, fmt, ap);
+    result = sprintfCore(NULL, buf, bufsize, fmt, ap);
     va_end(ap);
     return result;
 }
@@ -290,7 +291,7 @@ char *mprSprintfv(char *buf, ssize bufsize, cchar *fmt, va_list arg)
     mprAssert(fmt);
     mprAssert(bufsize > 0);
 
-    return sprintfCore(buf, bufsize, fmt, arg);
+    return sprintfCore(NULL, buf, bufsize, fmt, arg);
 }
 
 
@@ -302,7 +303,7 @@ char *mprAsprintf(cchar *fmt, ...)
     mprAssert(fmt);
 
     va_start(ap, fmt);
-    buf = sprintfCore(NULL, -1, fmt, ap);
+    buf = sprintfCore(NULL, NULL, -1, fmt, ap);
     va_end(ap);
     return buf;
 }
@@ -311,7 +312,28 @@ char *mprAsprintf(cchar *fmt, ...)
 char *mprAsprintfv(cchar *fmt, va_list arg)
 {
     mprAssert(fmt);
-    return sprintfCore(NULL, -1, fmt, arg);
+    return sprintfCore(NULL, NULL, -1, fmt, arg);
+}
+
+
+char *mprArenaFmt(MprArena *arena, cchar *fmt, ...)
+{
+    va_list     ap;
+    char        *buf;
+
+    mprAssert(arena);
+
+    va_start(ap, fmt);
+    buf = sprintfCore(arena, NULL, -1, fmt, ap);
+    va_end(ap);
+    return buf;
+}
+
+
+char *mprArenaFmtv(MprArena *arena, cchar *fmt, va_list arg)
+{
+    mprAssert(arena);
+    return sprintfCore(arena, NULL, -1, fmt, arg);
 }
 
 
@@ -331,7 +353,11 @@ static int getState(char c, int state)
 }
 
 
-static char *sprintfCore(char *buf, ssize maxsize, cchar *spec, va_list args)
+/*
+    Format into the supplied buffer. If buf is null, a buffer is allocated from the arena or, if the arena is null, 
+    from the heap.
+ */
+static char *sprintfCore(MprArena *arena, char *buf, ssize maxsize, cchar *spec, va_list args)
 {
     Format        fmt;
     MprEjsString  *es;
@@ -355,7 +381,7 @@ static char *sprintfCore(char *buf, ssize maxsize, cchar *spec, va_list args)
             maxsize = MAXINT;
         }
         len = min(MPR_SMALL_ALLOC, maxsize);
-        buf = mprAlloc(len);
+        buf = arena ? mprArenaAlloc(arena, len) : mprAlloc(len);
         if (buf == 0) {
             return 0;
         }
@@ -364,6 +390,7 @@ static char *sprintfCore(char *buf, ssize maxsize, cchar *spec, va_list args)
         fmt.growBy = min(MPR_SMALL_ALLOC * 2, maxsize - len);
     }
     fmt.maxsize = maxsize;
+    fmt.arena = arena;
     fmt.start = fmt.buf;
     fmt.end = fmt.buf;
     fmt.len = 0;
@@ -1051,7 +1078,11 @@ static int growBuf(Format *fmt)
          */
         return 0;
     }
-    newbuf = mprAlloc(buflen + fmt->growBy);
+    if (fmt->arena) {
+        newbuf = mprArenaAlloc(fmt->arena, buflen + fmt->growBy);
+    } else {
+        newbuf = mprAlloc(buflen + fmt->growBy);
+    }
     if (newbuf == 0) {
         mprAssert(!MPR_ERR_MEMORY);
         return MPR_ERR_MEMORY;
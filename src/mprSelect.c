@@ -270,13 +270,11 @@ static void serviceIO(MprWaitService *ws, int maxfd)
     Wake the wait service. WARNING: This routine must not require locking. MprEvents in scheduleDispatcher depends on this.
     Must be async-safe.
  */
-void mprWakeNotifier()
+void mprWakeWaitService(MprWaitService *ws)
 {
-    MprWaitService  *ws;
     ssize           rc;
     int             c;
 
-    ws = MPR->waitService;
     if (!ws->wakeRequested) {
         ws->wakeRequested = 1;
         c = 0;
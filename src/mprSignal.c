@@ -13,6 +13,7 @@
 
 static void manageSignal(MprSignal *sp, int flags);
 static void manageSignalService(MprSignalService *ssp, int flags);
+static void memProfileSignalHandler(char *path, MprSignal *sp);
 static void signalEvent(MprSignal *sp, MprEvent *event);
 static void signalHandler(int signo, siginfo_t *info, void *arg);
 static void standardSignalHandler(void *ignored, MprSignal *sp);
@@ -314,6 +315,31 @@ void mprAddStandardSignals()
 }
 
 
+int mprAddMemProfileSignal(int signo, cchar *path)
+{
+    MprSignal   *sp;
+
+    if ((sp = mprAddSignalHandler(signo, memProfileSignalHandler, sclone(path), 0, MPR_SIGNAL_AFTER)) == 0) {
+        return MPR_ERR_CANT_INITIALIZE;
+    }
+    /* Retain in the standard list so the handler is not collected */
+    mprAddItem(MPR->signalService->standard, sp);
+    return 0;
+}
+
+
+static void memProfileSignalHandler(char *path, MprSignal *sp)
+{
+    int     count;
+
+    if ((count = mprDumpMemProfile(path)) < 0) {
+        mprError("Cannot write memory profile to %s", path);
+    } else {
+        mprLog(2, "Wrote memory profile for %d allocation sites to %s", count, path);
+    }
+}
+
+
 static void standardSignalHandler(void *ignored, MprSignal *sp)
 {
     mprLog(6, "standardSignalHandler signo %d, flags %x", sp->signo, sp->flags);
@@ -349,6 +375,7 @@ static void standardSignalHandler(void *ignored, MprSignal *sp)
 
 #else /* BIT_UNIX_LIKE */
     void mprAddStandardSignals() {}
+    int mprAddMemProfileSignal(int signo, cchar *path) { return MPR_ERR_BAD_STATE; }
     MprSignalService *mprCreateSignalService() { return mprAlloc(0); }
     void mprStopSignalService() {};
     void mprRemoveSignalHandler(MprSignal *sp) { }
@@ -19,20 +19,48 @@
 #define BIT_HAS_GETADDRINFO 1
 #endif
 
+/*
+    Sockets owned by a single dispatcher skip locking on the I/O paths. Callers test the owned flag once and pass the 
+    same value to lock and unlock so a concurrent mprAddSocketHandler can't unbalance the lock.
+ */
+#define lockSocket(sp, owned)      do { if (!(owned)) lock(sp); } while (0)
+#define unlockSocket(sp, owned)    do { if (!(owned)) unlock(sp); } while (0)
+
+/*
+    Cached result of an address lookup
+ */
+typedef struct MprDnsEntry {
+    struct sockaddr_storage addr;       /* Resolved address */
+    MprSocklen      addrlen;            /* Length of addr */
+    int             family;             /* Protocol family */
+    int             protocol;           /* Protocol */
+    MprTime         expires;            /* When the entry expires */
+} MprDnsEntry;
+
 /******************************* Forward Declarations *************************/
 
+static int acceptConnection(MprSocket *listen, struct sockaddr *addr, MprSocklen *addrlen);
+static void addShardHandlers(MprSocket *sp, int mask, void *proc, void *data, int flags);
+#if LINUX && !__UCLIBC__
+static void closeRelay(MprSocket *sp);
+#endif
+static void closeShards(MprSocket *sp);
 static void closeSocket(MprSocket *sp, bool gracefully);
 static int connectSocket(MprSocket *sp, cchar *ipAddr, int port, int initialFlags);
 static MprSocketProvider *createStandardProvider(MprSocketService *ss);
 static void disconnectSocket(MprSocket *sp);
 static ssize flushSocket(MprSocket *sp);
+static MprSocket *getAcceptListener(MprSocket *listen);
+static int getDatagramAddr(MprSocket *sp);
 static int getSocketIpAddr(struct sockaddr *addr, int addrlen, char *ip, int size, int *port);
 static int ipv6(cchar *ip);
+static int listenShards(MprSocket *sp, cchar *ip, int port);
 static int listenSocket(MprSocket *sp, cchar *ip, int port, int initialFlags);
 static void manageSocket(MprSocket *sp, int flags);
 static void manageSocketService(MprSocketService *ss, int flags);
 static void manageSsl(MprSsl *ssl, int flags);
 static ssize readSocket(MprSocket *sp, void *buf, ssize bufsize);
+static ssize readStatus(MprSocket *sp, ssize bytes, int *retry);
 static ssize writeSocket(MprSocket *sp, cvoid *buf, ssize bufsize);
 
 /************************************ Code ************************************/
@@ -50,6 +78,9 @@ MprSocketService *mprCreateSocketService()
     }
     ss->maxAccept = MAXINT;
     ss->numAccept = 0;
+    ss->dnsCacheMax = MPR_DNS_CACHE_MAX;
+    ss->dnsCacheTtl = MPR_DNS_CACHE_TTL;
+    ss->dnsCache = mprCreateHash(0, 0);
 
     if ((ss->standardProvider = createStandardProvider(ss)) == 0) {
         return 0;
@@ -89,6 +120,7 @@ static void manageSocketService(MprSocketService *ss, int flags)
         mprMark(ss->defaultProvider);
         mprMark(ss->mutex);
         mprMark(ss->secureSockets);
+        mprMark(ss->dnsCache);
     }
 }
 
@@ -150,6 +182,7 @@ MprSocket *mprCreateSocket()
     sp->port = -1;
     sp->fd = -1;
     sp->flags = 0;
+    sp->relay[0] = sp->relay[1] = -1;
 
     sp->provider = ss->standardProvider;
     sp->service = ss;
@@ -172,6 +205,9 @@ static void manageSocket(MprSocket *sp, int flags)
         mprMark(sp->sslSocket);
         mprMark(sp->ssl);
         mprMark(sp->mutex);
+        mprMark(sp->shards);
+        mprMark(sp->addr);
+        mprMark(sp->relayFile);
 
     } else if (flags & MPR_MANAGE_FREE) {
         if (sp->fd >= 0) {
@@ -196,6 +232,7 @@ static void resetSocket(MprSocket *sp)
         sp->port = -1;
         sp->fd = -1;
         sp->ip = 0;
+        sp->addr = 0;
     }
     mprAssert(sp->provider);
 }
@@ -231,15 +268,23 @@ static int listenSocket(MprSocket *sp, cchar *ip, int port, int initialFlags)
     sp->ip = sclone(ip);
     sp->port = port;
     sp->flags = (initialFlags &
-        (MPR_SOCKET_BROADCAST | MPR_SOCKET_DATAGRAM | MPR_SOCKET_BLOCK |
+        (MPR_SOCKET_BROADCAST | MPR_SOCKET_DATAGRAM | MPR_SOCKET_BLOCK | MPR_SOCKET_REUSEPORT | MPR_SOCKET_OWNED |
          MPR_SOCKET_LISTENER | MPR_SOCKET_NOREUSE | MPR_SOCKET_NODELAY | MPR_SOCKET_THREAD));
 
     datagram = sp->flags & MPR_SOCKET_DATAGRAM;
+#if defined(SO_REUSEPORT)
+    if (datagram || (sp->flags & MPR_SOCKET_BLOCK)) {
+        sp->flags &= ~MPR_SOCKET_REUSEPORT;
+    }
+#else
+    sp->flags &= ~MPR_SOCKET_REUSEPORT;
+#endif
     if (mprGetSocketInfo(ip, port, &family, &protocol, &addr, &addrlen) < 0) {
         unlock(sp);
         return MPR_ERR_CANT_FIND;
     }
-    sp->fd = (int) socket(family, datagram ? SOCK_DGRAM: SOCK_STREAM, protocol);
+    /* The address lookup resolves a stream protocol. Let the stack choose the datagram protocol */
+    sp->fd = (int) socket(family, datagram ? SOCK_DGRAM: SOCK_STREAM, datagram ? 0 : protocol);
     if (sp->fd < 0) {
         unlock(sp);
         return MPR_ERR_CANT_OPEN;
@@ -257,6 +302,12 @@ static int listenSocket(MprSocket *sp, cchar *ip, int port, int initialFlags)
         rc = 1;
         setsockopt(sp->fd, SOL_SOCKET, SO_REUSEADDR, (char*) &rc, sizeof(rc));
     }
+#endif
+#if defined(SO_REUSEPORT)
+    if (sp->flags & MPR_SOCKET_REUSEPORT) {
+        rc = 1;
+        setsockopt(sp->fd, SOL_SOCKET, SO_REUSEPORT, (char*) &rc, sizeof(rc));
+    }
 #endif
     if (sp->service->prebind) {
         if ((sp->service->prebind)(sp) < 0) {
@@ -307,11 +358,54 @@ static int listenSocket(MprSocket *sp, cchar *ip, int port, int initialFlags)
     if (sp->flags & MPR_SOCKET_NODELAY) {
         mprSetSocketNoDelay(sp, 1);
     }
+    if ((sp->flags & MPR_SOCKET_REUSEPORT) && sp->listenSock == 0 && listenShards(sp, ip, port) < 0) {
+        unlock(sp);
+        mprCloseSocket(sp, 0);
+        return MPR_ERR_CANT_OPEN;
+    }
     unlock(sp);
     return sp->fd;
 }
 
 
+/*
+    Open an additional listener on the same port for each extra event loop. The kernel distributes incoming 
+    connections over the SO_REUSEPORT listeners.
+ */
+static int listenShards(MprSocket *sp, cchar *ip, int port)
+{
+    MprSocket               *shard;
+    struct sockaddr_storage addrStorage;
+    MprSocklen              addrlen;
+    char                    boundIp[MPR_MAX_IP_ADDR];
+    int                     i, count;
+
+    if ((count = mprGetEventLoops()) <= 1) {
+        return 0;
+    }
+    if (port <= 0) {
+        /* Bind the shards to the ephemeral port chosen for the first listener */
+        addrlen = sizeof(addrStorage);
+        if (getsockname(sp->fd, (struct sockaddr*) &addrStorage, &addrlen) < 0 ||
+                getSocketIpAddr((struct sockaddr*) &addrStorage, addrlen, boundIp, sizeof(boundIp), &port) < 0) {
+            return MPR_ERR_CANT_OPEN;
+        }
+    }
+    sp->shards = mprCreateList(count - 1, 0);
+    for (i = 1; i < count; i++) {
+        if ((shard = mprCreateSocket()) == 0) {
+            return MPR_ERR_MEMORY;
+        }
+        shard->listenSock = sp;
+        mprAddItem(sp->shards, shard);
+        if (listenSocket(shard, ip, port, sp->flags) < 0) {
+            return MPR_ERR_CANT_OPEN;
+        }
+    }
+    return 0;
+}
+
+
 MprWaitHandler *mprAddSocketHandler(MprSocket *sp, int mask, MprDispatcher *dispatcher, void *proc, void *data, int flags)
 {
     mprAssert(sp);
@@ -324,26 +418,67 @@ MprWaitHandler *mprAddSocketHandler(MprSocket *sp, int mask, MprDispatcher *disp
     if (sp->handler) {
         mprRemoveWaitHandler(sp->handler);
     }
+    if (flags & MPR_SOCKET_OWNED) {
+        sp->flags |= MPR_SOCKET_OWNED;
+        flags &= ~MPR_SOCKET_OWNED;
+    }
     sp->handler = mprCreateWaitHandler(sp->fd, mask, dispatcher, proc, data, flags);
+    if (sp->shards) {
+        addShardHandlers(sp, mask, proc, data, flags);
+    }
     return sp->handler;
 }
 
 
+/*
+    Add the handler to each shard listener. Shard N is serviced by event loop N.
+ */
+static void addShardHandlers(MprSocket *sp, int mask, void *proc, void *data, int flags)
+{
+    MprSocket   *shard;
+    int         next;
+
+    for (ITERATE_ITEMS(sp->shards, shard, next)) {
+        if (shard->handler) {
+            mprRemoveWaitHandler(shard->handler);
+        }
+        if (shard->dispatcher == 0) {
+            shard->dispatcher = mprCreateLoopDispatcher(sfmt("listen-%d", next), next, 1);
+        }
+        shard->handler = mprCreateWaitHandler(shard->fd, mask, shard->dispatcher, proc, data, flags);
+    }
+}
+
+
 void mprRemoveSocketHandler(MprSocket *sp)
 {
+    MprSocket   *shard;
+    int         next;
+
     if (sp->handler) {
         mprRemoveWaitHandler(sp->handler);
         sp->handler = 0;
     }
+    for (ITERATE_ITEMS(sp->shards, shard, next)) {
+        mprRemoveSocketHandler(shard);
+    }
 }
 
 
 void mprEnableSocketEvents(MprSocket *sp, int mask)
 {
+    MprSocket   *shard;
+    int         next;
+
     mprAssert(sp->handler);
     if (sp->handler) {
         mprWaitOn(sp->handler, mask);
     }
+    for (ITERATE_ITEMS(sp->shards, shard, next)) {
+        if (shard->handler) {
+            mprWaitOn(shard->handler, mask);
+        }
+    }
 }
 
 
@@ -372,7 +507,7 @@ static int connectSocket(MprSocket *sp, cchar *ip, int port, int initialFlags)
 
     sp->port = port;
     sp->flags = (initialFlags &
-        (MPR_SOCKET_BROADCAST | MPR_SOCKET_DATAGRAM | MPR_SOCKET_BLOCK |
+        (MPR_SOCKET_BROADCAST | MPR_SOCKET_DATAGRAM | MPR_SOCKET_BLOCK | MPR_SOCKET_OWNED |
          MPR_SOCKET_LISTENER | MPR_SOCKET_NOREUSE | MPR_SOCKET_NODELAY | MPR_SOCKET_THREAD));
     sp->flags |= MPR_SOCKET_CLIENT;
     sp->ip = sclone(ip);
@@ -389,10 +524,16 @@ static int connectSocket(MprSocket *sp, cchar *ip, int port, int initialFlags)
         unlock(sp);
         return MPR_ERR_CANT_ACCESS;
     }
-    if ((sp->fd = (int) socket(family, datagram ? SOCK_DGRAM: SOCK_STREAM, protocol)) < 0) {
+    if ((sp->fd = (int) socket(family, datagram ? SOCK_DGRAM: SOCK_STREAM, datagram ? 0 : protocol)) < 0) {
         unlock(sp);
         return MPR_ERR_CANT_OPEN;
     }
+    if (datagram) {
+        /* Keep the destination for writes. It is re-resolved after the DNS cache lifespan. See getDatagramAddr */
+        sp->addr = addr;
+        sp->addrlen = addrlen;
+        sp->addrExpires = mprGetTime() + MPR->socketService->dnsCacheTtl;
+    }
 #if !BIT_WIN_LIKE && !VXWORKS
     /*  
         Children should not inherit this fd
@@ -505,6 +646,42 @@ void mprCloseSocket(MprSocket *sp, bool gracefully)
     }
     mprRemoveSocketHandler(sp);
     sp->provider->closeSocket(sp, gracefully);
+    if (sp->shards) {
+        closeShards(sp);
+    }
+}
+
+
+#if LINUX && !__UCLIBC__
+/*
+    Close the relay pipe and discard any bytes held in it
+ */
+static void closeRelay(MprSocket *sp)
+{
+    if (sp->relay[0] >= 0) {
+        close(sp->relay[0]);
+        close(sp->relay[1]);
+        sp->relay[0] = sp->relay[1] = -1;
+    }
+    sp->relayed = 0;
+    sp->relayFile = 0;
+}
+#endif
+
+
+static void closeShards(MprSocket *sp)
+{
+    MprSocket   *shard;
+    int         next;
+
+    for (ITERATE_ITEMS(sp->shards, shard, next)) {
+        mprCloseSocket(shard, 0);
+        if (shard->dispatcher) {
+            mprDestroyDispatcher(shard->dispatcher);
+            shard->dispatcher = 0;
+        }
+    }
+    sp->shards = 0;
 }
 
 
@@ -551,13 +728,13 @@ static void closeSocket(MprSocket *sp, bool gracefully)
         closesocket(sp->fd);
         sp->fd = -1;
     }
+#if LINUX && !__UCLIBC__
+    closeRelay(sp);
+#endif
 
-    if (! (sp->flags & (MPR_SOCKET_LISTENER | MPR_SOCKET_CLIENT))) {
-        mprLock(ss->mutex);
-        if (--ss->numAccept < 0) {
-            ss->numAccept = 0;
-        }
-        mprUnlock(ss->mutex);
+    if (sp->listenSock && !(sp->flags & (MPR_SOCKET_LISTENER | MPR_SOCKET_CLIENT))) {
+        /* Only accepted sockets are counted. See mprAcceptSocket */
+        mprAtomicAdd(&ss->numAccept, -1);
     }
     unlock(sp);
 }
@@ -580,12 +757,12 @@ MprSocket *mprAcceptSocket(MprSocket *listen)
     if (listen->flags & MPR_SOCKET_BLOCK) {
         mprYield(MPR_YIELD_STICKY);
     }
-    fd = (int) accept(listen->fd, addr, &addrlen);
+    fd = acceptConnection(listen, addr, &addrlen);
     if (listen->flags & MPR_SOCKET_BLOCK) {
         mprResetYield();
     }
     if (fd < 0) {
-        if (mprGetError() != EAGAIN) {
+        if (mprGetError() != EAGAIN && mprGetError() != EWOULDBLOCK) {
             mprError("socket: accept failed, errno %d", mprGetOsError());
         }
         return 0;
@@ -594,31 +771,23 @@ MprSocket *mprAcceptSocket(MprSocket *listen)
         closesocket(fd);
         return 0;
     }
+    nsp->fd = fd;
+    nsp->port = listen->port;
+    nsp->flags = listen->flags & ~(MPR_SOCKET_LISTENER | MPR_SOCKET_REUSEPORT);
+    nsp->listenSock = listen;
 
     /*  
-        Limit the number of simultaneous clients
+        Limit the number of simultaneous clients. The count is decremented when the socket is closed.
      */
-    mprLock(ss->mutex);
-    if (++ss->numAccept >= ss->maxAccept) {
-        mprUnlock(ss->mutex);
+    mprAtomicAdd(&ss->numAccept, 1);
+    if (ss->numAccept >= ss->maxAccept) {
         mprLog(2, "Rejecting connection, too many client connections (%d)", ss->numAccept);
         mprCloseSocket(nsp, 0);
         return 0;
     }
-    mprUnlock(ss->mutex);
-
-#if !BIT_WIN_LIKE && !VXWORKS
-    /* Prevent children inheriting this socket */
-    fcntl(fd, F_SETFD, FD_CLOEXEC);         
-#endif
-
-    nsp->fd = fd;
-    nsp->port = listen->port;
-    nsp->flags = listen->flags;
-    nsp->flags &= ~MPR_SOCKET_LISTENER;
-    nsp->listenSock = listen;
-
+#if !LINUX
     mprSetSocketBlockingMode(nsp, (nsp->flags & MPR_SOCKET_BLOCK) ? 1: 0);
+#endif
     if (nsp->flags & MPR_SOCKET_NODELAY) {
         mprSetSocketNoDelay(nsp, 1);
     }
@@ -647,6 +816,87 @@ MprSocket *mprAcceptSocket(MprSocket *listen)
 }
 
 
+/*
+    Select the listener to accept from. A shard handler runs on the shard's own dispatcher and accepts only from that 
+    shard so each event loop drains its own queue. The primary handler accepts only from the primary listener. 
+    Returns null if the caller is polling without handlers and every listener should be tried.
+ */
+static MprSocket *getAcceptListener(MprSocket *listen)
+{
+    MprSocket   *shard;
+    MprOsThread thread;
+    int         next;
+
+    if (listen->shards == 0) {
+        return listen;
+    }
+    thread = mprGetCurrentOsThread();
+    for (ITERATE_ITEMS(listen->shards, shard, next)) {
+        if (shard->dispatcher && shard->dispatcher->owner == thread) {
+            return shard;
+        }
+    }
+    return listen->handler ? listen : 0;
+}
+
+
+/*
+    Accept a connection on a listener or one of its shards.
+    On Linux, accept4 sets close-on-exec and the blocking mode in the same system call.
+ */
+static int acceptConnection(MprSocket *listen, struct sockaddr *addr, MprSocklen *addrlen)
+{
+    MprSocket   *sp, *only;
+    MprSocklen  len;
+    int         fd, i, count;
+
+    only = getAcceptListener(listen);
+    count = (only == 0) ? listen->shards->length + 1 : 1;
+    len = *addrlen;
+    fd = -1;
+    for (i = 0; i < count; i++) {
+        if ((sp = only) == 0) {
+            sp = (i == 0) ? listen : mprGetItem(listen->shards, i - 1);
+        }
+        if (sp == 0 || sp->fd < 0) {
+            continue;
+        }
+        *addrlen = len;
+#if LINUX
+        fd = accept4(sp->fd, addr, addrlen, SOCK_CLOEXEC | ((listen->flags & MPR_SOCKET_BLOCK) ? 0 : SOCK_NONBLOCK));
+#else
+        fd = (int) accept(sp->fd, addr, addrlen);
+#endif
+        if (fd >= 0) {
+#if !BIT_WIN_LIKE && !VXWORKS && !LINUX
+            /* Prevent children inheriting this socket */
+            fcntl(fd, F_SETFD, FD_CLOEXEC);         
+#endif
+            break;
+        }
+    }
+    return fd;
+}
+
+
+int mprAcceptSockets(MprSocket *listen, MprSocket **sockets, int max)
+{
+    MprSocket   *sp;
+    int         count;
+
+    mprAssert(listen);
+    mprAssert(sockets);
+
+    for (count = 0; count < max; count++) {
+        if ((sp = mprAcceptSocket(listen)) == 0) {
+            break;
+        }
+        sockets[count] = sp;
+    }
+    return count;
+}
+
+
 /*  
     Read data. Return -1 for EOF and errors. On success, return the number of bytes read.
  */
@@ -673,15 +923,16 @@ static ssize readSocket(MprSocket *sp, void *buf, ssize bufsize)
     struct sockaddr_storage server;
     MprSocklen              len;
     ssize                   bytes;
-    int                     errCode;
+    int                     owned, retry;
 
     mprAssert(buf);
     mprAssert(bufsize > 0);
     mprAssert(~(sp->flags & MPR_SOCKET_CLOSED));
 
-    lock(sp);
+    owned = (sp->flags & MPR_SOCKET_OWNED) != 0;
+    lockSocket(sp, owned);
     if (sp->flags & MPR_SOCKET_EOF) {
-        unlock(sp);
+        unlockSocket(sp, owned);
         return -1;
     }
 again:
@@ -697,10 +948,39 @@ again:
     if (sp->flags & MPR_SOCKET_BLOCK) {
         mprResetYield();
     }
+    bytes = readStatus(sp, bytes, &retry);
+    if (retry) {
+        goto again;
+    }
+
+#if KEEP && FOR_SSL
+    /*
+        If there is more buffered data to read, then ensure the handler recalls us again even if there is no more IO events.
+     */
+    if (isBufferedData()) {
+        if (sp->handler) {
+            mprRecallWaitHandler(sp->handler);
+        }
+    }
+#endif
+    unlockSocket(sp, owned);
+    return bytes;
+}
+
+
+/*
+    Map the result of a socket read. Returns the bytes read, zero if no data is available, -1 for EOF or a negative 
+    error code. Sets retry if the read was interrupted. Must be called locked.
+ */
+static ssize readStatus(MprSocket *sp, ssize bytes, int *retry)
+{
+    int     errCode;
+
+    *retry = 0;
     if (bytes < 0) {
         errCode = mprGetSocketError(sp);
         if (errCode == EINTR) {
-            goto again;
+            *retry = 1;
 
         } else if (errCode == EAGAIN || errCode == EWOULDBLOCK) {
             bytes = 0;                          /* No data available */
@@ -718,19 +998,192 @@ again:
         sp->flags |= MPR_SOCKET_EOF;
         bytes = -1;
     }
+    return bytes;
+}
 
-#if KEEP && FOR_SSL
-    /*
-        If there is more buffered data to read, then ensure the handler recalls us again even if there is no more IO events.
-     */
-    if (isBufferedData()) {
-        if (sp->handler) {
-            mprRecallWaitHandler(sp->handler);
+
+/*
+    Scatter read into a vector of buffers. Plain sockets use one readv. Secure sockets read each buffer in turn via 
+    the provider until a read returns short.
+ */
+ssize mprReadSocketVector(MprSocket *sp, MprIOVec *iovec, int count)
+{
+    ssize   bytes, total;
+    int     i, owned, retry;
+
+    mprAssert(sp);
+    mprAssert(iovec);
+    mprAssert(count > 0);
+
+    if (sp->provider == 0) {
+        return MPR_ERR_NOT_INITIALIZED;
+    }
+#if BIT_UNIX_LIKE
+    if (sp->sslSocket == 0) {
+        owned = (sp->flags & MPR_SOCKET_OWNED) != 0;
+        lockSocket(sp, owned);
+        if (sp->flags & MPR_SOCKET_EOF) {
+            unlockSocket(sp, owned);
+            return -1;
         }
+        do {
+            if (sp->flags & MPR_SOCKET_BLOCK) {
+                mprYield(MPR_YIELD_STICKY);
+            }
+            bytes = readv(sp->fd, (const struct iovec*) iovec, count);
+            if (sp->flags & MPR_SOCKET_BLOCK) {
+                mprResetYield();
+            }
+            bytes = readStatus(sp, bytes, &retry);
+        } while (retry);
+        unlockSocket(sp, owned);
+        return bytes;
     }
 #endif
-    unlock(sp);
-    return bytes;
+    for (total = i = 0; i < count; i++) {
+        if (iovec[i].len <= 0) {
+            continue;
+        }
+        if ((bytes = mprReadSocket(sp, iovec[i].start, iovec[i].len)) < 0) {
+            return (total > 0) ? total : bytes;
+        }
+        total += bytes;
+        if (bytes < iovec[i].len) {
+            break;
+        }
+    }
+    return total;
+}
+
+
+/*
+    Receive a batch of datagrams. Each message is received into one buffer and its length updated.
+    On Linux, this is one recvmmsg system call. Blocking sockets wait only for the first message.
+ */
+int mprReadSocketMessages(MprSocket *sp, MprIOVec *msgs, int count)
+{
+#if LINUX && !__UCLIBC__
+    struct mmsghdr  hdrs[MPR_SOCKET_MESSAGES];
+    int             i, owned, rc, errCode;
+
+    mprAssert(sp);
+    mprAssert(msgs);
+
+    if (!(sp->flags & MPR_SOCKET_DATAGRAM)) {
+        return MPR_ERR_BAD_STATE;
+    }
+    count = min(count, MPR_SOCKET_MESSAGES);
+    memset(hdrs, 0, count * sizeof(struct mmsghdr));
+    for (i = 0; i < count; i++) {
+        hdrs[i].msg_hdr.msg_iov = (struct iovec*) &msgs[i];
+        hdrs[i].msg_hdr.msg_iovlen = 1;
+    }
+    owned = (sp->flags & MPR_SOCKET_OWNED) != 0;
+    lockSocket(sp, owned);
+    do {
+        if (sp->flags & MPR_SOCKET_BLOCK) {
+            mprYield(MPR_YIELD_STICKY);
+        }
+        rc = recvmmsg(sp->fd, hdrs, count, (sp->flags & MPR_SOCKET_BLOCK) ? MSG_WAITFORONE : 0, NULL);
+        if (sp->flags & MPR_SOCKET_BLOCK) {
+            mprResetYield();
+        }
+        errCode = (rc < 0) ? mprGetSocketError(sp) : 0;
+    } while (rc < 0 && errCode == EINTR);
+    unlockSocket(sp, owned);
+    if (rc < 0) {
+        return (errCode == EAGAIN || errCode == EWOULDBLOCK) ? 0 : MPR_ERR_CANT_READ;
+    }
+    for (i = 0; i < rc; i++) {
+        msgs[i].len = hdrs[i].msg_len;
+    }
+    return rc;
+#else
+    ssize   bytes;
+    int     i;
+
+    if (!(sp->flags & MPR_SOCKET_DATAGRAM)) {
+        return MPR_ERR_BAD_STATE;
+    }
+    for (i = 0; i < count; i++) {
+        if ((bytes = mprReadSocket(sp, msgs[i].start, msgs[i].len)) <= 0) {
+            if (bytes < 0 && i == 0) {
+                return MPR_ERR_CANT_READ;
+            }
+            break;
+        }
+        msgs[i].len = bytes;
+        if (sp->flags & MPR_SOCKET_BLOCK) {
+            /* Don't block waiting for more messages */
+            return 1;
+        }
+    }
+    return i;
+#endif
+}
+
+
+/*
+    Send a batch of datagrams to the socket's address. Each buffer is sent as one message.
+    On Linux, this is one sendmmsg system call and the address is resolved once per batch.
+ */
+int mprWriteSocketMessages(MprSocket *sp, MprIOVec *msgs, int count)
+{
+#if LINUX && !__UCLIBC__
+    struct mmsghdr      hdrs[MPR_SOCKET_MESSAGES];
+    int                 i, owned, rc, errCode;
+
+    mprAssert(sp);
+    mprAssert(msgs);
+
+    if (!(sp->flags & (MPR_SOCKET_BROADCAST | MPR_SOCKET_DATAGRAM))) {
+        return MPR_ERR_BAD_STATE;
+    }
+    if (getDatagramAddr(sp) < 0) {
+        return MPR_ERR_CANT_FIND;
+    }
+    count = min(count, MPR_SOCKET_MESSAGES);
+    memset(hdrs, 0, count * sizeof(struct mmsghdr));
+    for (i = 0; i < count; i++) {
+        hdrs[i].msg_hdr.msg_name = sp->addr;
+        hdrs[i].msg_hdr.msg_namelen = sp->addrlen;
+        hdrs[i].msg_hdr.msg_iov = (struct iovec*) &msgs[i];
+        hdrs[i].msg_hdr.msg_iovlen = 1;
+    }
+    owned = (sp->flags & MPR_SOCKET_OWNED) != 0;
+    lockSocket(sp, owned);
+    do {
+        if (sp->flags & MPR_SOCKET_BLOCK) {
+            mprYield(MPR_YIELD_STICKY);
+        }
+        rc = sendmmsg(sp->fd, hdrs, count, MSG_NOSIGNAL);
+        if (sp->flags & MPR_SOCKET_BLOCK) {
+            mprResetYield();
+        }
+        errCode = (rc < 0) ? mprGetSocketError(sp) : 0;
+    } while (rc < 0 && errCode == EINTR);
+    unlockSocket(sp, owned);
+    if (rc < 0) {
+        return (errCode == EAGAIN || errCode == EWOULDBLOCK) ? 0 : MPR_ERR_CANT_WRITE;
+    }
+    return rc;
+#else
+    ssize   bytes;
+    int     i;
+
+    if (!(sp->flags & (MPR_SOCKET_BROADCAST | MPR_SOCKET_DATAGRAM))) {
+        return MPR_ERR_BAD_STATE;
+    }
+    for (i = 0; i < count; i++) {
+        if ((bytes = mprWriteSocket(sp, msgs[i].start, msgs[i].len)) != msgs[i].len) {
+            if (bytes < 0 && i == 0) {
+                return MPR_ERR_CANT_WRITE;
+            }
+            break;
+        }
+    }
+    return i;
+#endif
 }
 
 
@@ -757,19 +1210,18 @@ ssize mprWriteSocket(MprSocket *sp, cvoid *buf, ssize bufsize)
  */
 static ssize writeSocket(MprSocket *sp, cvoid *buf, ssize bufsize)
 {
-    struct sockaddr     *addr;
-    MprSocklen          addrlen;
     ssize               len, written, sofar;
-    int                 family, protocol, errCode;
+    int                 errCode, owned;
 
     mprAssert(buf);
     mprAssert(bufsize >= 0);
     mprAssert((sp->flags & MPR_SOCKET_CLOSED) == 0);
 
-    lock(sp);
+    owned = (sp->flags & MPR_SOCKET_OWNED) != 0;
+    lockSocket(sp, owned);
     if (sp->flags & (MPR_SOCKET_BROADCAST | MPR_SOCKET_DATAGRAM)) {
-        if (mprGetSocketInfo(sp->ip, sp->port, &family, &protocol, &addr, &addrlen) < 0) {
-            unlock(sp);
+        if (getDatagramAddr(sp) < 0) {
+            unlockSocket(sp, owned);
             return MPR_ERR_CANT_FIND;
         }
     }
@@ -780,19 +1232,19 @@ static ssize writeSocket(MprSocket *sp, cvoid *buf, ssize bufsize)
         len = bufsize;
         sofar = 0;
         while (len > 0) {
-            unlock(sp);
+            unlockSocket(sp, owned);
             if (sp->flags & MPR_SOCKET_BLOCK) {
                 mprYield(MPR_YIELD_STICKY);
             }
             if ((sp->flags & MPR_SOCKET_BROADCAST) || (sp->flags & MPR_SOCKET_DATAGRAM)) {
-                written = sendto(sp->fd, &((char*) buf)[sofar], (int) len, MSG_NOSIGNAL, addr, addrlen);
+                written = sendto(sp->fd, &((char*) buf)[sofar], (int) len, MSG_NOSIGNAL, sp->addr, sp->addrlen);
             } else {
                 written = send(sp->fd, &((char*) buf)[sofar], (int) len, MSG_NOSIGNAL);
             }
             if (sp->flags & MPR_SOCKET_BLOCK) {
                 mprResetYield();
             }
-            lock(sp);
+            lockSocket(sp, owned);
             if (written < 0) {
                 errCode = mprGetSocketError(sp);
                 if (errCode == EINTR) {
@@ -808,21 +1260,46 @@ static ssize writeSocket(MprSocket *sp, cvoid *buf, ssize bufsize)
                         continue;
                     }
 #endif
-                    unlock(sp);
+                    unlockSocket(sp, owned);
                     return sofar;
                 }
-                unlock(sp);
+                unlockSocket(sp, owned);
                 return -errCode;
             }
             len -= written;
             sofar += written;
         }
     }
-    unlock(sp);
+    unlockSocket(sp, owned);
     return sofar;
 }
 
 
+/*
+    Get the datagram destination address. This is kept on the socket and resolved again via the DNS cache once the 
+    cache lifespan has passed.
+ */
+static int getDatagramAddr(MprSocket *sp)
+{
+    struct sockaddr     *addr;
+    MprSocklen          addrlen;
+    MprTime             now;
+    int                 family, protocol;
+
+    now = mprGetTime();
+    if (sp->addr == 0 || now >= sp->addrExpires) {
+        /* Re-resolve when the lookup expires so DNS changes are seen. Keep the old address if the lookup fails */
+        sp->addrExpires = now + MPR->socketService->dnsCacheTtl;
+        if (mprGetSocketInfo(sp->ip, sp->port, &family, &protocol, &addr, &addrlen) < 0) {
+            return sp->addr ? 0 : MPR_ERR_CANT_FIND;
+        }
+        sp->addrlen = addrlen;
+        sp->addr = addr;
+    }
+    return 0;
+}
+
+
 /*  
     Write a string to the socket
  */
@@ -890,6 +1367,74 @@ static ssize localSendfile(MprSocket *sp, MprFile *file, MprOff offset, ssize le
 #endif
 
 
+#if LINUX && !__UCLIBC__
+/*
+    Cork a socket so partial frames are held until uncorked. Uncorking sends any pending data.
+ */
+static void corkSocket(MprSocket *sp, int on)
+{
+    setsockopt(sp->fd, IPPROTO_TCP, TCP_CORK, (char*) &on, sizeof(on));
+}
+
+
+/*
+    Write a vector with MSG_MORE so the kernel holds a partial frame for the data that follows. Retry if interrupted 
+    as writeSocket does.
+ */
+static ssize writeMore(MprSocket *sp, MprIOVec *iovec, int count)
+{
+    struct msghdr   msg;
+    ssize           rc;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = (struct iovec*) iovec;
+    msg.msg_iovlen = count;
+    do {
+        rc = sendmsg(sp->fd, &msg, MSG_MORE | MSG_NOSIGNAL);
+    } while (rc < 0 && mprGetSocketError(sp) == EINTR);
+    return rc;
+}
+
+
+/*
+    Splice data from a pipe or socket to a socket. Pipes are spliced directly. Other sources are spliced via a relay 
+    pipe kept on the socket. Data left in the relay by a short write is sent first on the next call for the same file.
+    If the transfer was abandoned and a different file is now being sent, the stale relay is discarded.
+ */
+static ssize spliceFile(MprSocket *sp, MprFile *file, ssize len)
+{
+    ssize   rc;
+
+    if (sp->relayed > 0 && sp->relayFile != file) {
+        closeRelay(sp);
+    }
+    if (sp->relay[0] < 0) {
+        rc = splice(file->fd, NULL, sp->fd, NULL, len, SPLICE_F_MOVE | SPLICE_F_MORE | SPLICE_F_NONBLOCK);
+        if (rc >= 0 || errno != EINVAL) {
+            return rc;
+        }
+        if (pipe2(sp->relay, O_CLOEXEC | O_NONBLOCK) < 0) {
+            sp->relay[0] = sp->relay[1] = -1;
+            return -1;
+        }
+    }
+    if (sp->relayed == 0) {
+        if ((rc = splice(file->fd, NULL, sp->relay[1], NULL, len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK)) <= 0) {
+            return rc;
+        }
+        sp->relayed = rc;
+        sp->relayFile = file;
+    }
+    if ((rc = splice(sp->relay[0], NULL, sp->fd, NULL, min(sp->relayed, len), SPLICE_F_MOVE | SPLICE_F_MORE)) > 0) {
+        if ((sp->relayed -= rc) == 0) {
+            sp->relayFile = 0;
+        }
+    }
+    return rc;
+}
+#endif
+
+
 /*  
     Write data from a file to a socket. Includes the ability to write header before and after the file data.
     Works even with a null "file" to just output the headers.
@@ -903,6 +1448,9 @@ MprOff mprSendFileToSocket(MprSocket *sock, MprFile *file, MprOff offset, MprOff
     MprOff          written, toWriteFile;
     ssize           i, rc, toWriteBefore, toWriteAfter, nbytes;
     int             done;
+#if LINUX && !__UCLIBC__
+    int             cork, err, splicing;
+#endif
 
     rc = 0;
 
@@ -942,7 +1490,29 @@ MprOff mprSendFileToSocket(MprSocket *sock, MprFile *file, MprOff offset, MprOff
             Linux sendfile does not have the integrated ability to send headers. Must do it separately here.
             I/O requests may return short (write fewer than requested bytes).
          */
+#if LINUX && !__UCLIBC__
+        /*
+            Coalesce headers, file data and trailers. With trailers, cork the socket for the whole response. Otherwise 
+            MSG_MORE on the headers is sufficient as the file data push completes the frame.
+         */
+        splicing = 0;
+        cork = sock->sslSocket == 0 && afterCount > 0 && (beforeCount > 0 || toWriteFile > 0);
+        if (cork) {
+            corkSocket(sock, 1);
+        }
+#endif
         if (beforeCount > 0) {
+#if LINUX && !__UCLIBC__
+            if (sock->sslSocket == 0 && !cork && toWriteFile > 0 && file && file->fd >= 0) {
+                if (sock->flags & MPR_SOCKET_BLOCK) {
+                    mprYield(MPR_YIELD_STICKY);
+                }
+                rc = writeMore(sock, beforeVec, beforeCount);
+                if (sock->flags & MPR_SOCKET_BLOCK) {
+                    mprResetYield();
+                }
+            } else
+#endif
             rc = mprWriteSocketVector(sock, beforeVec, beforeCount);
             if (rc > 0) {
                 written += rc;
@@ -962,11 +1532,20 @@ MprOff mprSendFileToSocket(MprSocket *sock, MprFile *file, MprOff offset, MprOff
                     mprYield(MPR_YIELD_STICKY);
                 }
 #if LINUX && !__UCLIBC__
+                if (splicing) {
+                    rc = spliceFile(sock, file, nbytes);
+                } else {
     #if BIT_HAS_OFF64
-                rc = sendfile64(sock->fd, file->fd, &offset, nbytes);
+                    rc = sendfile64(sock->fd, file->fd, &offset, nbytes);
     #else
-                rc = sendfile(sock->fd, file->fd, &off, nbytes);
+                    rc = sendfile(sock->fd, file->fd, &off, nbytes);
     #endif
+                    if (rc < 0 && (errno == EINVAL || errno == ESPIPE)) {
+                        /* Not a regular file. Pipes and sockets can be spliced */
+                        splicing = 1;
+                        rc = spliceFile(sock, file, nbytes);
+                    }
+                }
 #else
                 rc = localSendfile(sock, file, offset, nbytes);
 #endif
@@ -989,6 +1568,13 @@ MprOff mprSendFileToSocket(MprSocket *sock, MprFile *file, MprOff offset, MprOff
                 written += rc;
             }
         }
+#if LINUX && !__UCLIBC__
+        if (cork) {
+            err = errno;
+            corkSocket(sock, 0);
+            errno = err;
+        }
+#endif
     }
     if (rc < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
@@ -1189,7 +1775,44 @@ int mprGetSocketError(MprSocket *sp)
 }
 
 
+void mprSetDnsCache(int max, MprTime ttl)
+{
+    MprSocketService    *ss;
+
+    ss = MPR->socketService;
+    mprLock(ss->mutex);
+    ss->dnsCacheMax = max(max, 0);
+    ss->dnsCacheTtl = ttl;
+    if (ss->dnsCacheMax == 0) {
+        ss->dnsCache = mprCreateHash(0, 0);
+    }
+    mprUnlock(ss->mutex);
+}
+
+
 #if BIT_HAS_GETADDRINFO
+/*
+    Remove expired lookups. If none have expired, flush the cache. Must be called locked.
+ */
+static void pruneDnsCache(MprSocketService *ss)
+{
+    MprDnsEntry     *dp;
+    MprKey          *kp;
+    MprTime         now;
+
+    now = mprGetTime();
+    for (kp = 0; (kp = mprGetNextKey(ss->dnsCache, kp)) != 0; ) {
+        dp = (MprDnsEntry*) kp->data;
+        if (dp->expires <= now) {
+            mprRemoveKey(ss->dnsCache, kp->key);
+        }
+    }
+    if (mprGetHashLength(ss->dnsCache) >= ss->dnsCacheMax) {
+        ss->dnsCache = mprCreateHash(0, 0);
+    }
+}
+
+
 /*  
     Get a socket address from a host/port combination. If a host provides both IPv4 and IPv6 addresses, 
     prefer the IPv4 address.
@@ -1197,14 +1820,28 @@ int mprGetSocketError(MprSocket *sp)
 int mprGetSocketInfo(cchar *ip, int port, int *family, int *protocol, struct sockaddr **addr, socklen_t *addrlen)
 {
     MprSocketService    *ss;
+    MprDnsEntry         *dp;
     struct addrinfo     hints, *res, *r;
-    char                *portStr;
+    char                *portStr, *key;
     int                 v6;
 
     mprAssert(addr);
     ss = MPR->socketService;
 
     mprLock(ss->mutex);
+    key = 0;
+    if (ss->dnsCacheMax > 0) {
+        key = sfmt("%s:%d", ip ? ip : "", port);
+        if ((dp = mprLookupKey(ss->dnsCache, key)) != 0 && dp->expires > mprGetTime()) {
+            *addr = mprAlloc(sizeof(struct sockaddr_storage));
+            memcpy((char*) *addr, (char*) &dp->addr, dp->addrlen);
+            *addrlen = dp->addrlen;
+            *family = dp->family;
+            *protocol = dp->protocol;
+            mprUnlock(ss->mutex);
+            return 0;
+        }
+    }
     memset((char*) &hints, '\0', sizeof(hints));
 
     /*
@@ -1255,8 +1892,19 @@ int mprGetSocketInfo(cchar *ip, int port, int *family, int *protocol, struct soc
     *addrlen = (int) r->ai_addrlen;
     *family = r->ai_family;
     *protocol = r->ai_protocol;
-
     freeaddrinfo(res);
+
+    if (key && (dp = mprAllocStruct(MprDnsEntry)) != 0) {
+        if (mprGetHashLength(ss->dnsCache) >= ss->dnsCacheMax) {
+            pruneDnsCache(ss);
+        }
+        memcpy((char*) &dp->addr, (char*) *addr, *addrlen);
+        dp->addrlen = *addrlen;
+        dp->family = *family;
+        dp->protocol = *protocol;
+        dp->expires = mprGetTime() + ss->dnsCacheTtl;
+        mprAddKey(ss->dnsCache, key, dp);
+    }
     mprUnlock(ss->mutex);
     return 0;
 }
@@ -11,6 +11,10 @@
 
 #include    "mpr.h"
 
+/********************************** Forwards **********************************/
+
+static char *joinv(MprArena *arena, cchar *buf, va_list args);
+
 /************************************ Code ************************************/
 
 char *itos(int64 value)
@@ -212,6 +216,25 @@ char *sclone(cchar *str)
 }
 
 
+char *mprArenaClone(MprArena *arena, cchar *str)
+{
+    char    *ptr;
+    ssize   len;
+
+    mprAssert(arena);
+
+    if (str == 0) {
+        str = "";
+    }
+    len = slen(str);
+    if ((ptr = mprArenaAlloc(arena, len + 1)) != 0) {
+        memcpy(ptr, str, len);
+        ptr[len] = '\0';
+    }
+    return ptr;
+}
+
+
 int scmp(cchar *s1, cchar *s2)
 {
     if (s1 == s2) {
@@ -374,6 +397,29 @@ char *sjoin(cchar *str, ...)
 
 
 char *sjoinv(cchar *buf, va_list args)
+{
+    return joinv(NULL, buf, args);
+}
+
+
+char *mprArenaJoin(MprArena *arena, cchar *str, ...)
+{
+    va_list     ap;
+    char        *result;
+
+    mprAssert(arena);
+
+    va_start(ap, str);
+    result = joinv(arena, str, ap);
+    va_end(ap);
+    return result;
+}
+
+
+/*
+    Join strings into a buffer allocated from the arena or, if the arena is null, from the heap
+ */
+static char *joinv(MprArena *arena, cchar *buf, va_list args)
 {
     va_list     ap;
     char        *dest, *str, *dp;
@@ -389,7 +435,8 @@ char *sjoinv(cchar *buf, va_list args)
         required += slen(str);
         str = va_arg(ap, char*);
     }
-    if ((dest = mprAlloc(required)) == 0) {
+    dest = arena ? mprArenaAlloc(arena, required) : mprAlloc(required);
+    if (dest == 0) {
         return 0;
     }
     dp = dest;
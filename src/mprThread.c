@@ -19,7 +19,13 @@ static void manageThreadService(MprThreadService *ts, int flags);
 static void manageThread(MprThread *tp, int flags);
 static void manageWorker(MprWorker *worker, int flags);
 static void manageWorkerService(MprWorkerService *ws, int flags);
+static void adaptWorkers(MprWorkerService *ws, MprEvent *timer);
+static int popTask(MprWorker *worker, int steal, MprWorkerTask *task);
+static void pushTask(MprWorker *worker, MprWorkerProc proc, void *data, int pinned);
+static void startNewWorker(MprWorkerService *ws, MprWorkerProc proc, void *data);
 static void pruneWorkers(MprWorkerService *ws, MprEvent *timer);
+static int queueTask(MprWorkerService *ws, MprWorkerProc proc, void *data);
+static int stealTask(MprWorkerService *ws, MprWorker *thief, MprWorkerTask *task);
 static void threadProc(MprThread *tp);
 static void workerMain(MprWorker *worker, MprThread *tp);
 
@@ -49,6 +55,13 @@ MprThreadService *mprCreateThreadService()
     }
     ts->mainThread->isMain = 1;
     ts->mainThread->osThread = mprGetCurrentOsThread();
+    /*
+        The current thread is kept in thread local storage so the allocator can find its per-thread cache quickly
+     */
+    if ((ts->local = mprCreateThreadLocal()) == 0) {
+        return 0;
+    }
+    mprSetThreadData(ts->local, ts->mainThread);
     return ts;
 }
 
@@ -64,6 +77,7 @@ static void manageThreadService(MprThreadService *ts, int flags)
         mprMark(ts->threads);
         mprMark(ts->mainThread);
         mprMark(ts->cond);
+        mprMark(ts->local);
 
     } else if (flags & MPR_MANAGE_FREE) {
         mprStopThreadService();
@@ -85,6 +99,9 @@ MprThread *mprGetCurrentThread()
     int                 i;
 
     ts = MPR->threadService;
+    if (ts->local && (tp = mprGetThreadData(ts->local)) != 0) {
+        return tp;
+    }
     id = mprGetCurrentOsThread();
     if (ts->threads->mutex) {
         lock(ts->threads);
@@ -182,6 +199,7 @@ static void manageThread(MprThread *tp, int flags)
         if (ts->threads) {
             mprRemoveItem(ts->threads, tp);
         }
+        mprFlushMemCache(&tp->cache);
 #if BIT_WIN_LIKE
         if (tp->threadHandle) {
             CloseHandle(tp->threadHandle);
@@ -232,7 +250,10 @@ static void threadProc(MprThread *tp)
 #else
     tp->pid = getpid();
 #endif
+    mprSetThreadData(MPR->threadService->local, tp);
     (tp->entry)(tp->data, tp);
+    mprSetThreadData(MPR->threadService->local, NULL);
+    mprFlushMemCache(&tp->cache);
     mprRemoveItem(MPR->threadService->threads, tp);
 }
 
@@ -542,6 +563,7 @@ MprWorkerService *mprCreateWorkerService()
     ws->mutex = mprCreateLock();
     ws->minThreads = MPR_DEFAULT_MIN_THREADS;
     ws->maxThreads = MPR_DEFAULT_MAX_THREADS;
+    ws->limit = ws->maxThreads;
 
     /*
         Presize the lists so they cannot get memory allocation failures later on.
@@ -561,6 +583,7 @@ static void manageWorkerService(MprWorkerService *ws, int flags)
         mprMark(ws->idleThreads);
         mprMark(ws->mutex);
         mprMark(ws->pruneTimer);
+        mprMark(ws->adaptTimer);
     }
 }
 
@@ -568,6 +591,7 @@ static void manageWorkerService(MprWorkerService *ws, int flags)
 int mprStartWorkerService()
 {
     MprWorkerService    *ws;
+    cchar               *cp;
 
     /*
         Create a timer to trim excess workers
@@ -575,6 +599,9 @@ int mprStartWorkerService()
     ws = MPR->workerService;
     mprSetMinWorkers(ws->minThreads);
     ws->pruneTimer = mprCreateTimerEvent(NULL, "pruneWorkers", MPR_TIMEOUT_PRUNER, pruneWorkers, ws, MPR_EVENT_QUICK);
+    if ((cp = getenv("MPR_WORKER_TARGET_WAIT")) != 0) {
+        mprSetWorkerTargetWait(stoi(cp));
+    }
     return 0;
 }
 
@@ -590,6 +617,9 @@ void mprWakeWorkers()
     if (ws->pruneTimer) {
         mprRemoveEvent(ws->pruneTimer);
     }
+    if (ws->adaptTimer) {
+        mprRemoveEvent(ws->adaptTimer);
+    }
     /*
         Wake up all idle workers. Busy workers take care of themselves. An idle thread will wakeup, exit and be 
         removed from the busy list and then delete the thread. We progressively remove the last thread in the idle
@@ -613,6 +643,7 @@ void mprSetMinWorkers(int n)
     ws = MPR->workerService;
     mprLock(ws->mutex);
     ws->minThreads = n; 
+    ws->limit = max(ws->limit, n);
     mprLog(4, "Pre-start %d workers", ws->minThreads);
     
     while (ws->numThreads < ws->minThreads) {
@@ -637,6 +668,7 @@ void mprSetMaxWorkers(int n)
 
     mprLock(ws->mutex);
     ws->maxThreads = n; 
+    ws->limit = ws->targetWait ? min(ws->limit, n) : n;
     if (ws->numThreads > ws->maxThreads) {
         pruneWorkers(ws, 0);
     }
@@ -692,6 +724,37 @@ void mprActivateWorker(MprWorker *worker, MprWorkerProc proc, void *data)
 }
 
 
+/*
+    Run a task on a specific worker. If the worker is busy, the task is queued to run on that worker when it completes
+    its current work. This is used for dispatcher affinity where the previous worker is typically still finishing the
+    last service pass when the dispatcher is rescheduled. A busy worker is only used if it is still finishing a task 
+    with the same data or if no other worker is available. Otherwise returns MPR_ERR_BUSY so any worker can be used.
+ */
+int mprStartWorkerOn(MprWorker *worker, MprWorkerProc proc, void *data)
+{
+    MprWorkerService    *ws;
+
+    ws = worker->workerService;
+
+    mprLock(ws->mutex);
+    if (worker->state == MPR_WORKER_IDLE) {
+        worker->proc = proc;
+        worker->data = data;
+        changeState(worker, MPR_WORKER_BUSY);
+
+    } else if (worker->state == MPR_WORKER_BUSY && (worker->taskTail - worker->taskHead) < MPR_WORKER_TASKS &&
+            (worker->data == data || (ws->idleThreads->length == 0 && ws->numThreads >= ws->limit))) {
+        pushTask(worker, proc, data, 1);
+
+    } else {
+        mprUnlock(ws->mutex);
+        return MPR_ERR_BUSY;
+    }
+    mprUnlock(ws->mutex);
+    return 0;
+}
+
+
 void mprSetWorkerStartCallback(MprWorkerProc start)
 {
     MPR->workerService->startWorker = start;
@@ -705,7 +768,7 @@ int mprAvailableWorkers()
 
     ws = MPR->workerService;
     mprLock(ws->mutex);
-    count = mprGetListLength(ws->idleThreads) + (ws->maxThreads - ws->numThreads);
+    count = mprGetListLength(ws->idleThreads) + max(ws->limit - ws->numThreads, 0);
     mprUnlock(ws->mutex);
     return count;
 }
@@ -730,25 +793,29 @@ int mprStartWorker(MprWorkerProc proc, void *data)
         worker->data = data;
         changeState(worker, MPR_WORKER_BUSY);
 
-    } else if (ws->numThreads < ws->maxThreads) {
-
+    } else if (ws->numThreads < ws->limit) {
         /*
             Can't find an idle thread. Try to create more workers in the pool. Otherwise, we will have to wait. 
-            No need to wakeup the thread -- it will immediately go to work.
          */
-        worker = createWorker(ws, ws->stackSize);
+        startNewWorker(ws, proc, data);
 
-        ws->numThreads++;
-        ws->maxUseThreads = max(ws->numThreads, ws->maxUseThreads);
-        worker->proc = proc;
-        worker->data = data;
+    } else if (queueTask(ws, proc, data) == 0) {
+        /*
+            All workers are busy and can't create anymore. The task will be run by the first free worker.
+         */
+        LOG(6, "All workers busy, queued task. Queued %d", ws->queued);
 
-        changeState(worker, MPR_WORKER_BUSY);
-        mprStartThread(worker->thread);
+    } else if (ws->numThreads < ws->maxThreads) {
+        /*
+            The adaptive limit is below the maximum and the task queues are full. Raise the limit rather than fail.
+         */
+        ws->limit = ws->numThreads + 1;
+        ws->grows++;
+        startNewWorker(ws, proc, data);
 
     } else {
         /*
-            No free workers and can't create anymore
+            No free workers, can't create anymore and the worker task queues are full
          */
         mprError("No free workers. Increase ThreadLimit. (Count %d of %d)", ws->numThreads, ws->maxThreads);
         mprUnlock(ws->mutex);
@@ -759,6 +826,227 @@ int mprStartWorker(MprWorkerProc proc, void *data)
 }
 
 
+/*
+    Create a worker and start it running the given proc.
+    No need to wakeup the thread -- it will immediately go to work. Must be called locked.
+ */
+static void startNewWorker(MprWorkerService *ws, MprWorkerProc proc, void *data)
+{
+    MprWorker   *worker;
+
+    worker = createWorker(ws, ws->stackSize);
+    ws->numThreads++;
+    ws->maxUseThreads = max(ws->numThreads, ws->maxUseThreads);
+    worker->proc = proc;
+    worker->data = data;
+    changeState(worker, MPR_WORKER_BUSY);
+    mprStartThread(worker->thread);
+}
+
+
+/*
+    Queue a task on a busy worker. Prefer the current worker for locality, otherwise the worker with the fewest queued 
+    tasks. Must be called with ws->mutex locked so a worker cannot go idle while a task is being queued.
+ */
+static int queueTask(MprWorkerService *ws, MprWorkerProc proc, void *data)
+{
+    MprWorker   *worker, *wp;
+    MprThread   *tp;
+    int         next, count, least;
+
+    worker = 0;
+    tp = mprGetCurrentThread();
+    if (tp && tp->entry == (MprThreadProc) workerMain) {
+        worker = tp->data;
+        if (worker->state != MPR_WORKER_BUSY || (worker->taskTail - worker->taskHead) >= MPR_WORKER_TASKS) {
+            worker = 0;
+        }
+    }
+    if (worker == 0) {
+        least = MPR_WORKER_TASKS;
+        for (next = 0; (wp = mprGetNextItem(ws->busyThreads, &next)) != 0; ) {
+            if ((count = wp->taskTail - wp->taskHead) < least) {
+                worker = wp;
+                least = count;
+            }
+        }
+        if (worker == 0) {
+            return MPR_ERR_BUSY;
+        }
+    }
+    pushTask(worker, proc, data, 0);
+    return 0;
+}
+
+
+/*
+    Append a task to a worker task queue. Pinned tasks are not stolen by other workers until they have waited 
+    MPR_WORKER_PIN_WAIT. The caller must ensure the worker is busy and its queue is not full. 
+    Must be called with ws->mutex locked.
+ */
+static void pushTask(MprWorker *worker, MprWorkerProc proc, void *data, int pinned)
+{
+    MprWorkerTask   *tp;
+
+    mprSpinLock(&worker->taskLock);
+    tp = &worker->tasks[worker->taskTail % MPR_WORKER_TASKS];
+    tp->proc = proc;
+    tp->data = data;
+    tp->queued = mprGetHiResTime();
+    tp->pinned = pinned;
+    worker->taskTail++;
+    mprSpinUnlock(&worker->taskLock);
+    mprAtomicAdd(&worker->workerService->queued, 1);
+}
+
+
+/*
+    Take the oldest task from a worker queue. The owning worker and thieves both take the oldest task so tasks run in
+    the order they were queued and a busy owner can't starve older tasks by queueing new ones. Thieves don't take a 
+    recently pinned task.
+ */
+static int popTask(MprWorker *worker, int steal, MprWorkerTask *task)
+{
+    MprWorkerService    *ws;
+    MprWorkerTask       *tp;
+    MprTime             wait;
+
+    if (worker->taskTail == worker->taskHead) {
+        return 0;
+    }
+    mprSpinLock(&worker->taskLock);
+    if (worker->taskTail == worker->taskHead) {
+        mprSpinUnlock(&worker->taskLock);
+        return 0;
+    }
+    tp = &worker->tasks[worker->taskHead % MPR_WORKER_TASKS];
+    if (steal && tp->pinned && (mprGetHiResTime() - tp->queued) < MPR_WORKER_PIN_WAIT) {
+        mprSpinUnlock(&worker->taskLock);
+        return 0;
+    }
+    worker->taskHead++;
+    *task = *tp;
+    tp->proc = 0;
+    tp->data = 0;
+    if (worker->taskTail == worker->taskHead) {
+        worker->taskTail = worker->taskHead = 0;
+    }
+    mprSpinUnlock(&worker->taskLock);
+    ws = worker->workerService;
+    mprAtomicAdd(&ws->queued, -1);
+
+    /* Unlocked update of the interval maximum. An occasional lost sample is acceptable */
+    wait = mprGetHiResTime() - task->queued;
+    if (wait > ws->waitSample) {
+        ws->waitSample = wait;
+    }
+    return 1;
+}
+
+
+void mprSetWorkerTargetWait(MprTime usec)
+{
+    MprWorkerService    *ws;
+
+    ws = MPR->workerService;
+    mprLock(ws->mutex);
+    ws->targetWait = max(usec, 0);
+    if (ws->targetWait) {
+        /* Start from the number of CPUs and adapt from there */
+        ws->limit = max(ws->numThreads, (int) mprGetMemStats()->numCpu);
+        ws->limit = max(min(ws->limit, ws->maxThreads), ws->minThreads);
+        if (ws->adaptTimer == 0) {
+            ws->adaptTimer = mprCreateTimerEvent(NULL, "adaptWorkers", MPR_TIMEOUT_ADAPT, adaptWorkers, ws, 
+                MPR_EVENT_QUICK);
+        }
+    } else {
+        ws->limit = ws->maxThreads;
+        if (ws->adaptTimer) {
+            mprRemoveEvent(ws->adaptTimer);
+            ws->adaptTimer = 0;
+        }
+    }
+    mprUnlock(ws->mutex);
+}
+
+
+/*
+    Adapt the pool size limit to the queue wait. The wait is the longest wait of tasks run in the last interval or 
+    the age of the oldest task still queued.
+ */
+static void adaptWorkers(MprWorkerService *ws, MprEvent *timer)
+{
+    MprWorker       *worker;
+    MprWorkerTask   task;
+    MprTime         now, wait;
+    int             next, count, step;
+
+    now = mprGetHiResTime();
+    mprLock(ws->mutex);
+    if (ws->targetWait == 0) {
+        mprUnlock(ws->mutex);
+        return;
+    }
+    wait = ws->waitSample;
+    ws->waitSample = 0;
+    if (ws->queued > 0) {
+        for (next = 0; (worker = mprGetNextItem(ws->busyThreads, &next)) != 0; ) {
+            mprSpinLock(&worker->taskLock);
+            if (worker->taskTail != worker->taskHead) {
+                wait = max(wait, now - worker->tasks[worker->taskHead % MPR_WORKER_TASKS].queued);
+            }
+            mprSpinUnlock(&worker->taskLock);
+        }
+    }
+    ws->lastWait = wait;
+
+    if (wait > ws->targetWait && ws->limit < ws->maxThreads) {
+        step = max(ws->limit / 4, 1);
+        ws->limit = min(ws->limit + step, ws->maxThreads);
+        ws->grows++;
+        mprLog(5, "Worker queue wait %Ld usec over target, raise worker limit to %d", wait, ws->limit);
+        /*
+            Start new workers with tasks taken from the queues so the start hook always sees a real task
+         */
+        for (count = ws->queued; count > 0 && ws->numThreads < ws->limit; count--) {
+            if (!stealTask(ws, 0, &task)) {
+                break;
+            }
+            startNewWorker(ws, task.proc, task.data);
+        }
+
+    } else if (wait < (ws->targetWait / 2) && ws->idleThreads->length > 0 && ws->limit > ws->minThreads) {
+        ws->limit = max(ws->limit - 1, max(ws->minThreads, 1));
+        ws->shrinks++;
+        mprLog(5, "Worker queue wait %Ld usec under target, lower worker limit to %d", wait, ws->limit);
+        if (ws->numThreads > ws->limit && (worker = mprGetLastItem(ws->idleThreads)) != 0) {
+            changeState(worker, MPR_WORKER_PRUNED);
+        }
+    }
+    mprUnlock(ws->mutex);
+}
+
+
+/*
+    Steal the oldest task from the busy worker with the most queued tasks. Must be called with ws->mutex locked.
+ */
+static int stealTask(MprWorkerService *ws, MprWorker *thief, MprWorkerTask *task)
+{
+    MprWorker   *worker, *victim;
+    int         next, count, most;
+
+    victim = 0;
+    most = 0;
+    for (next = 0; (worker = mprGetNextItem(ws->busyThreads, &next)) != 0; ) {
+        if (worker != thief && (count = worker->taskTail - worker->taskHead) > most) {
+            victim = worker;
+            most = count;
+        }
+    }
+    return victim ? popTask(victim, 1, task) : 0;
+}
+
+
 /*
     Trim idle workers
  */
@@ -791,7 +1079,7 @@ int mprGetAvailableWorkers()
     MprWorkerService  *ws;
 
     ws = MPR->workerService;
-    return (int) ws->idleThreads->length + (ws->maxThreads - ws->numThreads); 
+    return (int) ws->idleThreads->length + max(ws->limit - ws->numThreads, 0);
 }
 
 
@@ -825,6 +1113,12 @@ void mprGetWorkerServiceStats(MprWorkerService *ws, MprWorkerStats *stats)
     stats->maxUse = ws->maxUseThreads;
     stats->idleThreads = (int) ws->idleThreads->length;
     stats->busyThreads = (int) ws->busyThreads->length;
+    stats->queued = ws->queued;
+    stats->limit = ws->limit;
+    stats->targetWait = ws->targetWait;
+    stats->lastWait = ws->lastWait;
+    stats->grows = ws->grows;
+    stats->shrinks = ws->shrinks;
 }
 
 
@@ -847,6 +1141,7 @@ static MprWorker *createWorker(MprWorkerService *ws, ssize stackSize)
     worker->state = 0;
     worker->workerService = ws;
     worker->idleCond = mprCreateCond();
+    mprInitSpinLock(&worker->taskLock);
 
     mprSprintf(name, sizeof(name), "worker.%u", getNextThreadNum(ws));
     worker->thread = mprCreateThread(name, (MprThreadProc) workerMain, worker, stackSize);
@@ -856,11 +1151,19 @@ static MprWorker *createWorker(MprWorkerService *ws, ssize stackSize)
 
 static void manageWorker(MprWorker *worker, int flags)
 {
+    int     i;
+
     if (flags & MPR_MANAGE_MARK) {
         mprMark(worker->data);
         mprMark(worker->thread);
         mprMark(worker->workerService);
         mprMark(worker->idleCond);
+        for (i = worker->taskHead; i < worker->taskTail; i++) {
+            mprMark(worker->tasks[i % MPR_WORKER_TASKS].data);
+        }
+
+    } else if (flags & MPR_MANAGE_FREE) {
+        mprManageSpinLock(&worker->taskLock, MPR_MANAGE_FREE);
     }
 }
 
@@ -868,6 +1171,7 @@ static void manageWorker(MprWorker *worker, int flags)
 static void workerMain(MprWorker *worker, MprThread *tp)
 {
     MprWorkerService    *ws;
+    MprWorkerTask       task;
 
     ws = MPR->workerService;
     mprAssert(worker->state == MPR_WORKER_BUSY);
@@ -882,9 +1186,25 @@ static void workerMain(MprWorker *worker, MprThread *tp)
         if (worker->proc) {
             mprUnlock(ws->mutex);
             (*worker->proc)(worker->data, worker);
+            /*
+                Run tasks queued on this worker without taking the service lock or sleeping on the idle cond
+             */
+            while (popTask(worker, 0, &task)) {
+                worker->data = task.data;
+                (*task.proc)(task.data, worker);
+            }
             mprLock(ws->mutex);
             worker->proc = 0;
         }
+        /*
+            Steal queued work before going idle. The lock prevents tasks being queued after the check. A task may have 
+            been queued on this worker after it last checked its own task queue.
+         */
+        if (ws->queued > 0 && (popTask(worker, 0, &task) || stealTask(ws, worker, &task))) {
+            worker->proc = task.proc;
+            worker->data = task.data;
+            continue;
+        }
         worker->lastActivity = MPR->eventService->now;
         changeState(worker, MPR_WORKER_IDLE);
 
@@ -897,12 +1217,19 @@ static void workerMain(MprWorker *worker, MprThread *tp)
         mprUnlock(ws->mutex);
 
         /*
-            Sleep till there is more work to do. Yield for GC first.
+            Sleep till there is more work to do. Yield for GC first. If tasks are still queued, they may be pinned to 
+            a busy worker. Wake after the pin wait so they can be stolen if that worker is still busy.
          */
         mprYield(MPR_YIELD_STICKY);
-        mprWaitForCond(worker->idleCond, -1);
+        mprWaitForCond(worker->idleCond, ws->queued > 0 ? max(MPR_WORKER_PIN_WAIT / 1000, 1) : -1);
         mprResetYield();
         mprLock(ws->mutex);
+        if (worker->state == MPR_WORKER_IDLE && worker->proc == 0 && ws->queued > 0 && 
+                stealTask(ws, worker, &task)) {
+            worker->proc = task.proc;
+            worker->data = task.data;
+            changeState(worker, MPR_WORKER_BUSY);
+        }
     }
     changeState(worker, 0);
     worker->thread = 0;
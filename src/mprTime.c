@@ -301,6 +301,21 @@ MprTime mprGetTime()
 }
 
 
+/*
+    Return monotonic time in microseconds. Used for measuring short intervals.
+ */
+MprTime mprGetHiResTime()
+{
+#if BIT_UNIX_LIKE && defined(CLOCK_MONOTONIC)
+    struct timespec  tv;
+    clock_gettime(CLOCK_MONOTONIC, &tv);
+    return (MprTime) (((MprTime) tv.tv_sec) * 1000000) + (tv.tv_nsec / 1000);
+#else
+    return mprGetTime() * 1000;
+#endif
+}
+
+
 /*
     Return the number of milliseconds until the given timeout has expired.
  */
@@ -21,7 +21,8 @@ static void manageWaitHandler(MprWaitHandler *wp, int flags);
 
 /************************************ Code ************************************/
 /*
-    Initialize the service
+    Initialize the service. The first wait service created is the primary service. Additional event loops each
+    create their own wait service.
  */
 MprWaitService *mprCreateWaitService()
 {
@@ -31,7 +32,9 @@ MprWaitService *mprCreateWaitService()
     if (ws == 0) {
         return 0;
     }
-    MPR->waitService = ws;
+    if (MPR->waitService == 0) {
+        MPR->waitService = ws;
+    }
     ws->handlers = mprCreateList(-1, MPR_LIST_STATIC_VALUES);
     ws->mutex = mprCreateLock();
     ws->spin = mprCreateSpinLock();
@@ -75,7 +78,14 @@ static MprWaitHandler *initWaitHandler(MprWaitHandler *wp, int fd, int mask, Mpr
 
     mprAssert(fd >= 0);
 
-    ws = MPR->waitService;
+    /*
+        Use the I/O notifier of the event loop that owns the dispatcher
+     */
+    if (dispatcher && dispatcher->service->waitService) {
+        ws = dispatcher->service->waitService;
+    } else {
+        ws = MPR->waitService;
+    }
     if (mprGetListLength(ws->handlers) == FD_SETSIZE) {
         mprError("io: Too many io handlers: %d\n", FD_SETSIZE);
         return 0;
@@ -102,7 +112,7 @@ static MprWaitHandler *initWaitHandler(MprWaitHandler *wp, int fd, int mask, Mpr
         }
         mprNotifyOn(ws, wp, mask);
         unlock(ws);
-        mprWakeNotifier();
+        mprWakeWaitService(ws);
     }
     return wp;
 }
@@ -150,7 +160,7 @@ void mprRemoveWaitHandler(MprWaitHandler *wp)
     ws = wp->service;
     lock(ws);
     if (wp->fd >= 0) {
-        if (wp->desiredMask) {
+        if (wp->desiredMask || wp->notifierIndex >= 0) {
             mprNotifyOn(ws, wp, 0);
         }
         mprRemoveItem(ws->handlers, wp);
@@ -160,7 +170,7 @@ void mprRemoveWaitHandler(MprWaitHandler *wp)
             wp->event = 0;
         }
     }
-    mprWakeNotifier();
+    mprWakeWaitService(ws);
     unlock(ws);
 }
 
@@ -199,7 +209,7 @@ void mprWaitOn(MprWaitHandler *wp, int mask)
             wp->service->needRecall = 1;
         }
         mprNotifyOn(wp->service, wp, mask);
-        mprWakeNotifier();
+        mprWakeWaitService(wp->service);
     }
     unlock(wp->service);
 }
@@ -210,21 +220,26 @@ void mprWaitOn(MprWaitHandler *wp, int mask)
  */
 void mprRecallWaitHandlerByFd(int fd)
 {
+    MprEventService *es;
     MprWaitService  *ws;
     MprWaitHandler  *wp;
-    int             index;
+    int             i, index;
 
-    ws = MPR->waitService;
-    lock(ws);
-    for (index = 0; (wp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &index)) != 0; ) {
-        if (wp->fd == fd) {
-            wp->flags |= MPR_WAIT_RECALL_HANDLER;
-            ws->needRecall = 1;
-            mprWakeNotifier();
-            break;
+    es = MPR->eventService;
+    for (i = 0; i < (es->loops ? es->loopCount : 1); i++) {
+        ws = (es->loops) ? es->loops[i]->waitService : MPR->waitService;
+        lock(ws);
+        for (index = 0; (wp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &index)) != 0; ) {
+            if (wp->fd == fd) {
+                wp->flags |= MPR_WAIT_RECALL_HANDLER;
+                ws->needRecall = 1;
+                mprWakeWaitService(ws);
+                unlock(ws);
+                return;
+            }
         }
+        unlock(ws);
     }
-    unlock(ws);
 }
 
 
@@ -232,15 +247,40 @@ void mprRecallWaitHandler(MprWaitHandler *wp)
 {
     MprWaitService  *ws;
 
-    ws = MPR->waitService;
+    ws = wp->service;
     lock(ws);
     wp->flags |= MPR_WAIT_RECALL_HANDLER;
     ws->needRecall = 1;
-    mprWakeNotifier();
+    mprWakeWaitService(ws);
     unlock(ws);
 }
 
 
+/*
+    Wake the I/O notifiers of all event loops. WARNING: This routine must not require locking. Must be async-safe.
+ */
+void mprWakeNotifier()
+{
+    MprEventService *es, *loop, **loops;
+    int             i, count;
+
+    if ((es = MPR->eventService) == 0 || (loops = es->loops) == 0) {
+        if (MPR->waitService) {
+            mprWakeWaitService(MPR->waitService);
+        }
+        return;
+    }
+    /* The loops array is never reallocated and loops are stored before loopCount is incremented */
+    count = es->loopCount;
+    mprAtomicBarrier();
+    for (i = 0; i < count; i++) {
+        if ((loop = loops[i]) != 0 && loop->waitService) {
+            mprWakeWaitService(loop->waitService);
+        }
+    }
+}
+
+
 /*
     Recall a handler which may have buffered data. Only called by notifiers.
  */
@@ -24,12 +24,15 @@ static App *app;
 /***************************** Forward Declarations ***************************/
 
 static void     doBenchmark(void *thread);
+static void     echoBenchmark(int count, int flags, char *msg);
 static void     endMark(MprTime start, int count, char *msg);
 static void     eventCallback(void *data, MprEvent *ep);
+static void     latencyCallback(void *data, MprEvent *ep);
 static void     manageApp(App *app, int flags);
 static MprTime  startMark();
 static void     testMalloc();
 static void     timerCallback(void *data, MprEvent *ep);
+static void     waitForComplete();
 volatile int    testComplete;
 
 /*********************************** Code *************************************/
@@ -41,7 +44,7 @@ MAIN(benchMpr, int argc, char **argv, char **envp)
     char            *argp;
     int             err, nextArg;
 
-    if ((mpr = mprCreate(argc, argv, 0)) == 0) {
+    if ((mpr = mprCreate(argc, argv, MPR_USER_EVENTS_THREAD)) == 0) {
         return MPR_ERR_MEMORY;
     }
     if ((app = mprAllocObj(App, manageApp)) == 0) {
@@ -111,8 +114,6 @@ static void doBenchmark(void *thread)
     int             count, i;
     MprMutex        *lock;
 
-    mprYield(MPR_YIELD_STICKY);
-
     mprPrintf("Group\t%-30s\t%13s\t%12s\n", "Benchmark", "Microsec", "Elapsed-sec");
 
     testMalloc();
@@ -166,9 +167,9 @@ static void doBenchmark(void *thread)
         app->markCount = count;
         start = startMark();
         for (i = 0; i < count; i++) {
-            mprCreateEvent(NULL, "eventBenchmark", 0, eventCallback, ITOP(i), MPR_EVENT_QUICK);
+            mprCreateEvent(NULL, "eventBenchmark", 0, eventCallback, ITOP(i), MPR_EVENT_QUICK | MPR_EVENT_STATIC_DATA);
         }
-        mprWaitForCond(app->complete, -1);
+        waitForComplete();
         endMark(start, count, "Event (create|run|delete)");
 
 
@@ -181,11 +182,33 @@ static void doBenchmark(void *thread)
         app->markCount = count;
         start = startMark();
         for (i = 0; i < count; i++) {
-            mprCreateTimerEvent(NULL, "timerBenchmark", 0, timerCallback, (void*) (long) i, 0);
+            mprCreateTimerEvent(NULL, "timerBenchmark", 0, timerCallback, (void*) (long) i, MPR_EVENT_STATIC_DATA);
         }
-        mprWaitForCond(app->complete, -1);
+        waitForComplete();
         endMark(start, count, "Timer (create|delete)");
 
+        /*
+            Cross-thread event latency. Each event is queued while the event service thread is idle, so this measures
+            the wakeup of the notifier plus the signal back to this thread.
+         */
+        mprPrintf("Cross-thread Event Latency\n");
+        count = 20000 * app->iterations;
+        start = startMark();
+        for (i = 0; i < count; i++) {
+            mprResetCond(app->complete);
+            mprCreateEvent(NULL, "latencyBenchmark", 0, latencyCallback, NULL, MPR_EVENT_QUICK | MPR_EVENT_STATIC_DATA);
+            waitForComplete();
+        }
+        endMark(start, count, "Event wakeup round trip");
+
+        /*
+            Loopback echo. Compare locked sockets with dispatcher-owned sockets that skip the socket mutex.
+         */
+        mprPrintf("Socket Benchmarks\n");
+        count = 20000 * app->iterations;
+        echoBenchmark(count, 0, "Socket echo (locked)");
+        echoBenchmark(count, MPR_SOCKET_OWNED, "Socket echo (owned)");
+
         /*
             Alloc (1K)
          */
@@ -202,6 +225,51 @@ static void doBenchmark(void *thread)
 }
 
 
+/*
+    Echo a small message over a loopback connection. Both ends use blocking I/O on this thread.
+ */
+static void echoBenchmark(int count, int flags, char *msg)
+{
+    MprSocket           *server, *client, *accepted;
+    struct sockaddr_in  addr;
+    MprSocklen          addrlen;
+    MprTime             start;
+    char                buf[64];
+    int                 i;
+
+    flags |= MPR_SOCKET_BLOCK | MPR_SOCKET_NODELAY;
+    server = mprCreateSocket();
+    client = mprCreateSocket();
+    mprAddRoot(server);
+    mprAddRoot(client);
+    addrlen = sizeof(addr);
+    accepted = 0;
+    if (mprListenOnSocket(server, "127.0.0.1", 0, flags) < 0 || 
+            getsockname(server->fd, (struct sockaddr*) &addr, &addrlen) < 0 ||
+            mprConnectSocket(client, "127.0.0.1", ntohs(addr.sin_port), flags) < 0 ||
+            (accepted = mprAcceptSocket(server)) == 0) {
+        mprPrintf("\t%-30s\tCan't open loopback connection\n", msg);
+    } else {
+        mprAddRoot(accepted);
+        memset(buf, 'x', sizeof(buf));
+        start = startMark();
+        for (i = 0; i < count; i++) {
+            mprWriteSocket(client, buf, sizeof(buf));
+            mprReadSocket(accepted, buf, sizeof(buf));
+            mprWriteSocket(accepted, buf, sizeof(buf));
+            mprReadSocket(client, buf, sizeof(buf));
+        }
+        mprCloseSocket(accepted, 0);
+        mprRemoveRoot(accepted);
+        mprCloseSocket(client, 0);
+        mprCloseSocket(server, 0);
+        endMark(start, count, msg);
+    }
+    mprRemoveRoot(client);
+    mprRemoveRoot(server);
+}
+
+
 static void testMalloc()
 {
     MprTime     start;
@@ -351,6 +419,15 @@ static void eventCallback(void *data, MprEvent *event)
 }
 
 
+/*
+    Latency callback. Runs on the event service thread.
+ */
+static void latencyCallback(void *data, MprEvent *event)
+{
+    mprSignalCond(app->complete);
+}
+
+
 /*
     Timer callback 
  */
@@ -365,6 +442,17 @@ static void timerCallback(void *data, MprEvent *event)
 }
 
 
+/*
+    Wait for the event service thread to signal completion. Yield while waiting so the GC is not blocked.
+ */
+static void waitForComplete()
+{
+    mprYield(MPR_YIELD_STICKY);
+    mprWaitForCond(app->complete, -1);
+    mprResetYield();
+}
+
+
 static MprTime startMark()
 {
     return mprGetTime();
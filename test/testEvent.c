@@ -10,10 +10,32 @@
 
 /*********************************** Locals ***********************************/
 
+#define TEST_TIMERS     8
+#define TEST_PRODUCERS  4
+#define TEST_POSTS      250
+
 typedef struct TestEvent {
-    MprEvent    *event;
+    MprEvent        *event;
+    MprDispatcher   *dispatchers[TEST_TIMERS];
+    volatile int    fired;
+    int             cancelledRan;
+    int             outOfOrder;
+    int             lastSeq[TEST_PRODUCERS];
+    MprThread       *thread;
+    int             otherThread;
+    volatile int    hold;
+    volatile int    blocked;
 } TestEvent;
 
+/*
+    Event posted by a producer thread
+ */
+typedef struct TestPost {
+    MprTestGroup    *gp;
+    int             producer;
+    int             seq;
+} TestPost;
+
 static void manageTestEvent(TestEvent *te, int flags);
 
 /************************************ Code ************************************/
@@ -32,8 +54,14 @@ static int initEvent(MprTestGroup *gp)
 
 static void manageTestEvent(TestEvent *te, int flags)
 {
+    int     i;
+
     if (flags & MPR_MANAGE_MARK) {
         mprMark(te->event);
+        for (i = 0; i < TEST_TIMERS; i++) {
+            mprMark(te->dispatchers[i]);
+        }
+        mprMark(te->thread);
     }
 }
 
@@ -98,12 +126,473 @@ static void testReschedEvent(MprTestGroup *gp)
 }
 
 
+/*
+    Timer callback for testTimerOrder. Signal completion when all the uncancelled timers have fired.
+ */
+static void timerCallback(void *data, MprEvent *event)
+{
+    MprTestGroup    *gp;
+    TestEvent       *te;
+
+    gp = data;
+    te = gp->data;
+    if (scmp(event->name, "cancelled") == 0) {
+        te->cancelledRan = 1;
+    }
+    mprAtomicAdd(&te->fired, 1);
+    if (te->fired == TEST_TIMERS - 1) {
+        mprSignalTestComplete(gp);
+    }
+}
+
+
+/*
+    Queue timers on separate dispatchers in reverse due order and cancel the earliest. This exercises the waitHeap.
+ */
+static void testTimerOrder(MprTestGroup *gp)
+{
+    TestEvent   *te;
+    MprEvent    *event;
+    int         i;
+
+    te = gp->data;
+    te->fired = 0;
+    te->cancelledRan = 0;
+
+    for (i = 0; i < TEST_TIMERS; i++) {
+        te->dispatchers[i] = mprCreateDispatcher("testTimerOrder", 1);
+        assert(te->dispatchers[i] != 0);
+    }
+    for (i = 0; i < TEST_TIMERS - 1; i++) {
+        event = mprCreateEvent(te->dispatchers[i], "timer", (TEST_TIMERS - i) * 10, timerCallback, (void*) gp, 0);
+        assert(event != 0);
+    }
+    te->event = mprCreateEvent(te->dispatchers[i], "cancelled", 10, timerCallback, (void*) gp, 0);
+    assert(te->event != 0);
+    mprRemoveEvent(te->event);
+
+    assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+    assert(te->fired == TEST_TIMERS - 1);
+    assert(!te->cancelledRan);
+
+    for (i = 0; i < TEST_TIMERS; i++) {
+        mprDestroyDispatcher(te->dispatchers[i]);
+        te->dispatchers[i] = 0;
+    }
+    te->event = 0;
+}
+
+
+/*
+    Spread dispatchers over multiple event loops and run a timer on each
+ */
+static void testEventLoops(MprTestGroup *gp)
+{
+    TestEvent   *te;
+    MprEvent    *event;
+    int         i, spread, prior;
+
+    te = gp->data;
+    te->fired = 0;
+    te->cancelledRan = 0;
+
+    prior = mprGetEventLoops();
+    if (mprSetEventLoops(2) < 2) {
+        /* Not supported on this platform */
+        return;
+    }
+    assert(mprGetEventLoops() >= 2);
+
+    spread = 0;
+    for (i = 0; i < TEST_TIMERS; i++) {
+        te->dispatchers[i] = mprCreateDispatcher("testEventLoops", 1);
+        assert(te->dispatchers[i] != 0);
+        if (te->dispatchers[i]->service != te->dispatchers[0]->service) {
+            spread = 1;
+        }
+    }
+    assert(spread);
+
+    for (i = 0; i < TEST_TIMERS - 1; i++) {
+        event = mprCreateEvent(te->dispatchers[i], "timer", 10, timerCallback, (void*) gp, 0);
+        assert(event != 0);
+    }
+    assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+    assert(te->fired == TEST_TIMERS - 1);
+
+    for (i = 0; i < TEST_TIMERS; i++) {
+        mprDestroyDispatcher(te->dispatchers[i]);
+        te->dispatchers[i] = 0;
+    }
+    /* Loops are never destroyed, but new dispatchers revert to the prior number of loops */
+    mprSetEventLoops(prior);
+    if (gp->service->numThreads <= 1) {
+        assert(mprGetEventLoops() == prior);
+    }
+}
+
+
+#if MPR_EVENT_EPOLL
+static void ioCallback(MprTestGroup *gp, MprEvent *event)
+{
+    TestEvent   *te;
+    char        c;
+
+    te = gp->data;
+    if (read(event->fd, &c, 1) == 1) {
+        te->fired++;
+        mprSignalTestComplete(gp);
+    }
+}
+
+
+/*
+    Register, complete, remove and re-register a wait handler on the same fd using an io_uring event loop
+ */
+static void testEventUring(MprTestGroup *gp)
+{
+    TestEvent       *te;
+    MprDispatcher   *dispatcher;
+    MprWaitService  *ws;
+    MprWaitHandler  *wp;
+    char            *prior;
+    int             fds[2], loops, i;
+
+    te = gp->data;
+    te->fired = 0;
+    loops = mprGetEventLoops();
+    prior = getenv("MPR_IO_URING") ? sclone(getenv("MPR_IO_URING")) : 0;
+    setenv("MPR_IO_URING", "1", 1);
+    /* Create a new loop as surplus loops created by prior tests will be using epoll */
+    mprSetEventLoops(max(MPR->eventService->loopCount, 1) + 1);
+    if (prior) {
+        setenv("MPR_IO_URING", prior, 1);
+    } else {
+        unsetenv("MPR_IO_URING");
+    }
+    dispatcher = te->dispatchers[0] = mprCreateLoopDispatcher("testEventUring", mprGetEventLoops() - 1, 1);
+    assert(dispatcher != 0);
+    ws = dispatcher->service->waitService;
+    if (ws == 0 || ws->uring == 0 || pipe(fds) < 0) {
+        /* io_uring is not available */
+        mprDestroyDispatcher(dispatcher);
+        te->dispatchers[0] = 0;
+        mprSetEventLoops(loops);
+        return;
+    }
+    for (i = 0; i < 2; i++) {
+        assert(write(fds[1], "x", 1) == 1);
+        wp = mprCreateWaitHandler(fds[0], MPR_READABLE, dispatcher, ioCallback, gp, 0);
+        assert(wp != 0);
+        mprAddRoot(wp);
+        assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+        assert(te->fired == i + 1);
+
+        /* The one-shot request has completed. Removing the handler must also remove it from the fd map */
+        mprRemoveWaitHandler(wp);
+        assert(fds[0] >= ws->handlerMax || ws->handlerMap[fds[0]] == 0);
+        mprRemoveRoot(wp);
+    }
+    close(fds[0]);
+    close(fds[1]);
+    mprDestroyDispatcher(dispatcher);
+    te->dispatchers[0] = 0;
+    mprSetEventLoops(loops);
+}
+#endif
+
+
+static void postCallback(TestPost *post, MprEvent *event)
+{
+    TestEvent   *te;
+
+    te = post->gp->data;
+    /* Events on one dispatcher run serially */
+    if (post->seq != te->lastSeq[post->producer] + 1) {
+        te->outOfOrder = 1;
+    }
+    te->lastSeq[post->producer] = post->seq;
+    if (++te->fired == TEST_PRODUCERS * TEST_POSTS) {
+        mprSignalTestComplete(post->gp);
+    }
+}
+
+
+static void postThread(TestPost *thread, MprThread *tp)
+{
+    TestEvent   *te;
+    TestPost    *post;
+    int         i;
+
+    te = thread->gp->data;
+    for (i = 0; i < TEST_POSTS; i++) {
+        if ((post = mprAllocObj(TestPost, 0)) == 0) {
+            return;
+        }
+        post->gp = thread->gp;
+        post->producer = thread->producer;
+        post->seq = i;
+        mprCreateEvent(te->dispatchers[0], "post", 0, postCallback, post, 0);
+    }
+}
+
+
+/*
+    Post immediate events to one dispatcher from several threads. Each producer's events must run in order.
+ */
+static void testPostEvents(MprTestGroup *gp)
+{
+    TestEvent   *te;
+    TestPost    *thread;
+    MprThread   *tp;
+    int         i;
+
+    te = gp->data;
+    te->fired = 0;
+    te->outOfOrder = 0;
+
+    te->dispatchers[0] = mprCreateDispatcher("testPostEvents", 1);
+    assert(te->dispatchers[0] != 0);
+
+    for (i = 0; i < TEST_PRODUCERS; i++) {
+        te->lastSeq[i] = -1;
+    }
+    for (i = 0; i < TEST_PRODUCERS; i++) {
+        if ((thread = mprAllocObj(TestPost, 0)) == 0) {
+            assert(thread != 0);
+            return;
+        }
+        thread->gp = gp;
+        thread->producer = i;
+        tp = mprCreateThread("testPost", (MprThreadProc) postThread, thread, 0);
+        assert(tp != 0);
+        assert(mprStartThread(tp) == 0);
+    }
+    assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+    assert(te->fired == TEST_PRODUCERS * TEST_POSTS);
+    assert(!te->outOfOrder);
+
+    mprDestroyDispatcher(te->dispatchers[0]);
+    te->dispatchers[0] = 0;
+}
+
+
+static void batchCallback(MprTestGroup *gp, MprEvent *event)
+{
+    TestEvent   *te;
+    MprThread   *tp;
+
+    te = gp->data;
+    tp = mprGetCurrentThread();
+    if (te->thread == 0) {
+        te->thread = tp;
+    } else if (tp != te->thread) {
+        te->otherThread = 1;
+    }
+    if (++te->fired == TEST_TIMERS) {
+        mprSignalTestComplete(gp);
+    }
+}
+
+
+/*
+    Run more events than the batch limit on a dispatcher with worker affinity
+ */
+static void testEventBatch(MprTestGroup *gp)
+{
+    TestEvent       *te;
+    MprEventStats   *stats;
+    MprEvent        *event;
+    int             i, prior, priorStats;
+
+    te = gp->data;
+    te->fired = 0;
+    te->thread = 0;
+    te->otherThread = 0;
+
+    /* Stats record the number of events run in each service pass */
+    priorStats = (MPR->eventService->stats != 0);
+    mprSetEventStats(1);
+    /* Queue all events before enabling the dispatcher so each pass has more events than the limit */
+    te->dispatchers[0] = mprCreateDispatcher("testEventBatch", 0);
+    assert(te->dispatchers[0] != 0);
+    mprSetDispatcherAffinity(te->dispatchers[0], 1);
+
+    prior = mprSetEventBatch(2);
+    for (i = 0; i < TEST_TIMERS; i++) {
+        event = mprCreateEvent(te->dispatchers[0], "batch", 0, batchCallback, (void*) gp, 0);
+        assert(event != 0);
+    }
+    mprEnableDispatcher(te->dispatchers[0]);
+    assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+    assert(te->fired == TEST_TIMERS);
+
+    stats = mprGetEventStats(te->dispatchers[0]);
+    if (stats && gp->service->numThreads <= 1) {
+        /* 
+            Each pass runs on the worker that ran the previous pass. Other test threads may change the batch limit 
+            or hold the worker long enough for the pass to be taken by another worker.
+         */
+        assert(!te->otherThread);
+
+        /* The last pass is recorded after it signals completion */
+        for (i = 0; i < 100 && stats->events < TEST_TIMERS; i++) {
+            mprNap(10);
+        }
+        assert(stats->events == TEST_TIMERS);
+        assert(stats->maxBatch == 2);
+        assert(stats->batches == TEST_TIMERS / 2);
+    }
+    mprSetEventBatch(prior);
+    mprSetEventStats(priorStats);
+
+    mprDestroyDispatcher(te->dispatchers[0]);
+    te->dispatchers[0] = 0;
+}
+
+static void affinityCallback(MprTestGroup *gp, MprEvent *event)
+{
+    TestEvent   *te;
+
+    te = gp->data;
+    if (te->thread == 0) {
+        te->thread = mprGetCurrentThread();
+    } else if (mprGetCurrentThread() != te->thread) {
+        te->otherThread = 1;
+    }
+    te->fired++;
+    mprSignalTestComplete(gp);
+}
+
+
+static void blockProc(TestEvent *te, MprWorker *worker)
+{
+    te->blocked = 1;
+    /* Allow the collector to run while blocked */
+    mprYield(MPR_YIELD_STICKY);
+    while (te->hold) {
+        mprNap(5);
+    }
+    mprResetYield();
+    te->blocked = 0;
+}
+
+
+/*
+    Block the worker that last ran an affinity dispatcher. The next event must be run by another worker.
+ */
+static void testEventAffinity(MprTestGroup *gp)
+{
+    TestEvent       *te;
+    MprDispatcher   *dispatcher;
+    MprEvent        *event;
+    MprTime         mark;
+    int             rc;
+
+    te = gp->data;
+    te->fired = 0;
+    te->thread = 0;
+    te->otherThread = 0;
+
+    dispatcher = te->dispatchers[0] = mprCreateDispatcher("testEventAffinity", 1);
+    assert(dispatcher != 0);
+    mprSetDispatcherAffinity(dispatcher, 1);
+    event = mprCreateEvent(dispatcher, "affinity", 0, affinityCallback, (void*) gp, 0);
+    assert(event != 0);
+    assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+    assert(dispatcher->lastWorker != 0);
+
+    /* Wait for the last worker to go idle and then block it. Yield so the collector can run meanwhile */
+    te->hold = 1;
+    mark = mprGetTime();
+    mprYield(MPR_YIELD_STICKY);
+    while ((rc = mprStartWorkerOn(dispatcher->lastWorker, (MprWorkerProc) blockProc, te)) < 0 && 
+            mprGetRemainingTime(mark, MPR_TEST_SLEEP) > 0) {
+        mprNap(5);
+    }
+    while (rc == 0 && !te->blocked && mprGetRemainingTime(mark, MPR_TEST_SLEEP) > 0) {
+        mprNap(5);
+    }
+    mprResetYield();
+    assert(rc == 0);
+    assert(te->blocked);
+
+    event = mprCreateEvent(dispatcher, "affinity", 0, affinityCallback, (void*) gp, 0);
+    assert(event != 0);
+    assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+    assert(te->fired == 2);
+    assert(te->otherThread);
+    assert(te->blocked);
+
+    te->hold = 0;
+    mprDestroyDispatcher(dispatcher);
+    te->dispatchers[0] = 0;
+}
+
+
+static void testEventStats(MprTestGroup *gp)
+{
+    TestEvent       *te;
+    MprEventStats   *stats;
+    MprEvent        *event;
+    cchar           *json;
+    int             i, prior;
+
+    te = gp->data;
+    te->fired = 0;
+
+    prior = (MPR->eventService->stats != 0);
+    mprSetEventStats(1);
+
+    /* Hold the events for a known delay before enabling the dispatcher */
+    te->dispatchers[0] = mprCreateDispatcher("testEventStats", 0);
+    assert(te->dispatchers[0] != 0);
+    for (i = 0; i < TEST_TIMERS; i++) {
+        event = mprCreateEvent(te->dispatchers[0], "stats", 0, batchCallback, (void*) gp, 0);
+        assert(event != 0);
+    }
+    mprNap(20);
+    mprEnableDispatcher(te->dispatchers[0]);
+    assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+
+    if (gp->service->numThreads <= 1) {
+        /* Other test threads may disable stats */
+        stats = mprGetEventStats(te->dispatchers[0]);
+        assert(stats != 0);
+        if (stats) {
+            /* The last event is recorded after its callback signals completion */
+            for (i = 0; i < 100 && stats->events < TEST_TIMERS; i++) {
+                mprNap(10);
+            }
+            assert(stats->events == TEST_TIMERS);
+            /* Queue wait is in usec */
+            assert(stats->maxQueueWait >= 20 * 1000);
+            assert(stats->totalQueueWait >= TEST_TIMERS * 20 * 1000);
+        }
+        json = mprSerialize(mprGetEventStatsObj(), 0);
+        assert(json && scontains(json, "testEventStats") && scontains(json, "queueWait"));
+    }
+    mprDestroyDispatcher(te->dispatchers[0]);
+    te->dispatchers[0] = 0;
+    mprSetEventStats(prior);
+}
+
+
 MprTestDef testEvent = {
     "event", 0, initEvent, 0,
     {
         MPR_TEST(0, testCreateEvent),
         MPR_TEST(0, testCancelEvent),
         MPR_TEST(0, testReschedEvent),
+        MPR_TEST(0, testTimerOrder),
+        MPR_TEST(0, testEventLoops),
+#if MPR_EVENT_EPOLL
+        MPR_TEST(0, testEventUring),
+#endif
+        MPR_TEST(0, testPostEvents),
+        MPR_TEST(0, testEventBatch),
+        MPR_TEST(0, testEventAffinity),
+        MPR_TEST(0, testEventStats),
         MPR_TEST(0, 0),
     },
 };
@@ -182,11 +182,354 @@ static void testAllocLongevity(MprTestGroup *gp)
 }
 
 
+static void testAllocCache(MprTestGroup *gp)
+{
+    MprMemStats *stats;
+    char        *blocks[64];
+    uint64      hits;
+    int         i, j;
+
+    /*
+        Small allocations from MPR threads are satisfied from the per-thread allocation cache
+     */
+    hits = mprGetMemStats()->cacheHits;
+    for (i = 0; i < 64; i++) {
+        blocks[i] = mprAlloc(24);
+        assert(blocks[i] != 0);
+        memset(blocks[i], i, 24);
+    }
+    for (i = 0; i < 64; i++) {
+        for (j = 0; j < 24; j++) {
+            assert(blocks[i][j] == i);
+        }
+    }
+    stats = mprGetMemStats();
+    if (mprGetCurrentThread()) {
+        assert(stats->cacheHits > hits);
+    }
+}
+
+
+/*
+    Small blocks are allocated from slab regions dedicated to their block size
+ */
+static void testAllocSlab(MprTestGroup *gp)
+{
+    char        *blocks[256];
+    int         i, j;
+
+    for (i = 0; i < 256; i++) {
+        blocks[i] = mprAlloc(40);
+        assert(blocks[i] != 0);
+        assert(mprGetBlockSize(blocks[i]) >= 40);
+        memset(blocks[i], i, 40);
+    }
+    for (i = 0; i < 256; i++) {
+        for (j = 0; j < 40; j++) {
+            assert(blocks[i][j] == (char) i);
+        }
+    }
+    assert(mprGetMemStats()->slabs > 0);
+}
+
+
+/*
+    Collect with both parallel and lazy sweeping. Blocks held by the cache must survive both.
+ */
+static void testAllocSweep(MprTestGroup *gp)
+{
+    Cache       *cache;
+    uchar       *cp;
+    int         i, j, lazy;
+
+    cache = mprAllocObj(Cache, cacheManager);
+    assert(cache != 0);
+    mprAddRoot(cache);
+
+    for (lazy = 0; lazy <= 1; lazy++) {
+        mprSetGCLazySweep(lazy);
+        for (i = 0; i < CACHE_MAX; i++) {
+            cp = cache->blocks[i] = mprAlloc(512);
+            assert(cp != 0);
+            memset(cp, i, 512);
+            /* Garbage to sweep */
+            assert(mprAlloc(1024) != 0);
+        }
+        mprRequestGC(MPR_FORCE_GC | MPR_COMPLETE_GC | MPR_WAIT_GC);
+        for (i = 0; i < CACHE_MAX; i++) {
+            cp = cache->blocks[i];
+            for (j = 0; j < 512; j++) {
+                assert(cp[j] == (uchar) i);
+            }
+        }
+    }
+    mprSetGCLazySweep(1);
+    mprRemoveRoot(cache);
+}
+
+
+/*
+    Allocate with all region placement options. Large blocks force new regions.
+ */
+static void testAllocPlacement(MprTestGroup *gp)
+{
+    char        *mp;
+    ssize       size;
+    int         i, chunkSize;
+
+    chunkSize = MPR->heap->chunkSize;
+    mprSetMemPlacement(MPR_MEM_HUGE_PAGES | MPR_MEM_NUMA | MPR_MEM_DONTNEED);
+    for (i = 0; i < 4; i++) {
+        size = (i + 1) * 1024 * 1024;
+        mp = mprAlloc(size);
+        assert(mp != 0);
+        memset(mp, i, size);
+        assert(mp[0] == i && mp[size - 1] == i);
+    }
+    mprSetMemPlacement(0);
+    assert(MPR->heap->chunkSize == chunkSize);
+}
+
+
+/*
+    Sample allocations and write a collapsed stack profile
+ */
+static void testMemProfile(MprTestGroup *gp)
+{
+    Cache       *cache;
+    char        *path, *data;
+    int         i, count;
+
+    assert(mprStartMemProfile(1024) == 0);
+    cache = mprAllocObj(Cache, cacheManager);
+    assert(cache != 0);
+    mprAddRoot(cache);
+    for (i = 0; i < CACHE_MAX; i++) {
+        cache->blocks[i] = mprAlloc(4096);
+        assert(cache->blocks[i] != 0);
+    }
+    path = mprGetTempPath(NULL);
+    assert(path != 0);
+    count = mprDumpMemProfile(path);
+    assert(count > 0);
+    data = mprReadPathContents(path, NULL);
+    assert(data != 0 && *data != '\0');
+    assert(schr(data, ' ') != 0);
+    mprDeletePath(path);
+    mprStopMemProfile();
+    mprRemoveRoot(cache);
+}
+
+
+static void testGCStats(MprTestGroup *gp)
+{
+    MprGCStats  *gs;
+    MprHash     *obj;
+    cchar       *json;
+    uint64      cycles, count;
+    int         i;
+
+    gs = mprGetGCStats();
+    assert(gs != 0);
+    cycles = gs->cycles;
+    assert(mprAlloc(1024) != 0);
+    mprRequestGC(MPR_FORCE_GC | MPR_COMPLETE_GC | MPR_WAIT_GC);
+    assert(gs->cycles > cycles);
+    assert(gs->maxPause >= gs->lastPause);
+
+    for (count = i = 0; i < MPR_GC_PAUSE_BUCKETS; i++) {
+        count += gs->pauseHistogram[i];
+    }
+    assert(count > 0);
+
+    obj = mprGetGCStatsObj();
+    assert(obj != 0);
+    json = mprSerialize(obj, 0);
+    assert(json != 0);
+    assert(scontains(json, "cycles") != 0);
+    assert(scontains(json, "pauseHistogram: [") != 0);
+    assert(scontains(json, "yieldWait") != 0);
+}
+
+
+static void testGCNursery(MprTestGroup *gp)
+{
+    MprGCStats  *gs;
+    MprList     *list;
+    MprHash     *hash;
+    Cache       *cache, *holder;
+    char        *key;
+    uint64      minor;
+    int         i, enabled;
+
+    gs = mprGetGCStats();
+    enabled = mprGetMpr()->heap->nursery;
+    mprSetGCNursery(1);
+
+    /* Promote the containers to the old generation. Roots are always traced, so use a holder as the root */
+    holder = mprAllocObj(Cache, cacheManager);
+    holder->blocks[0] = list = mprCreateList(0, 0);
+    holder->blocks[1] = hash = mprCreateHash(0, 0);
+    holder->blocks[2] = cache = mprAllocObj(Cache, cacheManager);
+    mprAddRoot(holder);
+    mprRequestGC(MPR_FORCE_GC | MPR_COMPLETE_GC | MPR_WAIT_GC);
+
+    /* Store young blocks in old blocks with and without managers */
+    for (i = 0; i < CACHE_MAX; i++) {
+        key = sfmt("%d", i);
+        mprAddItem(list, sfmt("item-%d", i));
+        mprAddKey(hash, key, sfmt("value-%d", i));
+        cache->blocks[i] = sfmt("block-%d", i);
+    }
+    minor = gs->minorCycles;
+    for (i = 0; i < 8 && gs->minorCycles == minor; i++) {
+        mprRequestGC(MPR_FORCE_GC | MPR_WAIT_GC);
+    }
+    if (gp->service->numThreads <= 1) {
+        /* Other test threads may request complete collections */
+        assert(gs->minorCycles > minor);
+    }
+
+    for (i = 0; i < CACHE_MAX; i++) {
+        key = sfmt("%d", i);
+        assert(mprIsValid(mprGetItem(list, i)));
+        assert(smatch(mprGetItem(list, i), sfmt("item-%d", i)));
+        assert(smatch(mprLookupKey(hash, key), sfmt("value-%d", i)));
+        assert(smatch(cache->blocks[i], sfmt("block-%d", i)));
+    }
+    mprRemoveRoot(holder);
+    mprSetGCNursery(enabled);
+    mprRequestGC(MPR_FORCE_GC | MPR_COMPLETE_GC | MPR_WAIT_GC);
+}
+
+
+typedef struct ArenaObj {
+    int     *freed;
+} ArenaObj;
+
+static void manageArenaObj(ArenaObj *obj, int flags)
+{
+    if (flags & MPR_MANAGE_FREE) {
+        (*obj->freed)++;
+    }
+}
+
+
+static void testArena(MprTestGroup *gp)
+{
+    MprArena    *arena;
+    MprBuf      *buf;
+    ArenaObj    *obj;
+    char        *blocks[256], *str;
+    int         i, j, freed;
+
+    arena = mprCreateArena(0);
+    assert(arena != 0);
+    mprAddRoot(arena);
+
+    for (i = 0; i < 256; i++) {
+        blocks[i] = mprArenaAlloc(arena, 100 + i);
+        assert(blocks[i] != 0);
+        assert(mprGetBlockSize(blocks[i]) >= 100 + i);
+        memset(blocks[i], i, 100 + i);
+    }
+    freed = 0;
+    obj = mprArenaAllocObj(arena, ArenaObj, manageArenaObj);
+    assert(obj != 0);
+    obj->freed = &freed;
+
+    /* Arena blocks must survive collections while the arena is referenced */
+    mprRequestGC(MPR_FORCE_GC | MPR_COMPLETE_GC | MPR_WAIT_GC);
+    for (i = 0; i < 256; i++) {
+        for (j = 0; j < 100 + i; j++) {
+            assert(blocks[i][j] == (char) i);
+        }
+    }
+    assert(freed == 0);
+
+    str = mprArenaClone(arena, "hello");
+    assert(strcmp(str, "hello") == 0);
+    str = mprArenaFmt(arena, "%s-%d", "abc", 42);
+    assert(strcmp(str, "abc-42") == 0);
+    str = mprArenaJoin(arena, "a", "b", "c", NULL);
+    assert(strcmp(str, "abc") == 0);
+
+    buf = mprCreateArenaBuf(arena, 16, 0);
+    assert(buf != 0);
+    for (i = 0; i < 100; i++) {
+        mprPutStringToBuf(buf, "0123456789");
+    }
+    assert(mprGetBufLength(buf) == 1000);
+    assert(memcmp(&mprGetBufStart(buf)[990], "0123456789", 10) == 0);
+
+    assert(arena->allocated > 0);
+    mprResetArena(arena);
+    assert(freed == 1);
+    assert(arena->allocated == 0);
+    assert(mprArenaAlloc(arena, 64) != 0);
+    mprRemoveRoot(arena);
+}
+
+
+typedef struct ArenaRef {
+    char    *young;
+} ArenaRef;
+
+static void manageArenaRef(ArenaRef *ref, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(ref->young);
+    }
+}
+
+
+/*
+    Young blocks referenced only from an old arena must survive minor collections
+ */
+static void testArenaNursery(MprTestGroup *gp)
+{
+    MprGCStats  *gs;
+    MprArena    *arena;
+    ArenaRef    *ref;
+    uint64      minor;
+    int         i, enabled;
+
+    gs = mprGetGCStats();
+    enabled = mprGetMpr()->heap->nursery;
+    mprSetGCNursery(1);
+
+    arena = mprCreateArena(0);
+    assert(arena != 0);
+    mprAddRoot(arena);
+    ref = mprArenaAllocObj(arena, ArenaRef, manageArenaRef);
+    assert(ref != 0);
+    mprRequestGC(MPR_FORCE_GC | MPR_COMPLETE_GC | MPR_WAIT_GC);
+
+    ref->young = sfmt("young-%d", 42);
+    minor = gs->minorCycles;
+    for (i = 0; i < 8 && gs->minorCycles == minor; i++) {
+        mprRequestGC(MPR_FORCE_GC | MPR_WAIT_GC);
+    }
+    if (gp->service->numThreads <= 1) {
+        assert(gs->minorCycles > minor);
+    }
+    /* Reuse any memory freed by the collections */
+    for (i = 0; i < 1000; i++) {
+        mprAlloc(16);
+    }
+    assert(mprIsValid(ref->young));
+    assert(smatch(ref->young, "young-42"));
+
+    mprRemoveRoot(arena);
+    mprSetGCNursery(enabled);
+    mprRequestGC(MPR_FORCE_GC | MPR_COMPLETE_GC | MPR_WAIT_GC);
+}
+
+
 /*
     TODO missing tests for:
     - triggering memoryFailure callbacks
     - Memory redline limits
-    - Slab memory usage
  */
 MprTestDef testAlloc = {
     "alloc", 0, 0, 0,
@@ -196,6 +539,15 @@ MprTestDef testAlloc = {
         MPR_TEST(0, testLotsOfAlloc),
         MPR_TEST(0, testAllocIntegrityChecks),
         MPR_TEST(0, testAllocLongevity),
+        MPR_TEST(0, testAllocCache),
+        MPR_TEST(0, testAllocSlab),
+        MPR_TEST(0, testAllocSweep),
+        MPR_TEST(0, testAllocPlacement),
+        MPR_TEST(0, testMemProfile),
+        MPR_TEST(0, testGCStats),
+        MPR_TEST(0, testGCNursery),
+        MPR_TEST(0, testArena),
+        MPR_TEST(0, testArenaNursery),
         MPR_TEST(0, 0),
     },
 };
@@ -19,6 +19,10 @@ typedef struct TestSocket {
     int             port;                       /* Server port */
 } TestSocket;
 
+#define TEST_BATCH  8                            /* Connections to accept as a batch */
+#define TEST_BODY   4096                         /* Size of file data to send */
+#define TEST_MESSAGES 4                          /* Datagrams to send as a batch */
+
 static int warnNoInternet = 0;
 static int bufsize = 16 * 1024;
 
@@ -316,6 +320,408 @@ static void testClientSslv4(MprTestGroup *gp)
 }
 
 
+/*
+    Accept a burst of connections with one call. Use an ephemeral port so concurrent groups don't share SO_REUSEPORT 
+    listeners.
+ */
+static void testBatchAccept(MprTestGroup *gp)
+{
+    MprSocket           *server, *clients[TEST_BATCH], *accepted[TEST_BATCH];
+    struct sockaddr_in  addr;
+    MprSocklen          addrlen;
+    MprTime             mark;
+    int                 i, count, rc;
+
+    server = mprCreateSocket(NULL);
+    mprAddRoot(server);
+    rc = mprListenOnSocket(server, "127.0.0.1", 0, MPR_SOCKET_NODELAY | MPR_SOCKET_REUSEPORT);
+    assert(rc >= 0);
+    if (rc < 0) {
+        mprRemoveRoot(server);
+        return;
+    }
+    addrlen = sizeof(addr);
+    rc = getsockname(server->fd, (struct sockaddr*) &addr, &addrlen);
+    assert(rc == 0);
+
+    for (i = 0; i < TEST_BATCH; i++) {
+        clients[i] = mprCreateSocket(NULL);
+        mprAddRoot(clients[i]);
+        rc = mprConnectSocket(clients[i], "127.0.0.1", ntohs(addr.sin_port), 0);
+        assert(rc >= 0);
+    }
+    count = 0;
+    mark = mprGetTime();
+    do {
+        for (i = count, count += mprAcceptSockets(server, &accepted[count], TEST_BATCH - count); i < count; i++) {
+            mprAddRoot(accepted[i]);
+        }
+        if (count < TEST_BATCH) {
+            mprNap(10);
+        }
+    } while (count < TEST_BATCH && mprGetRemainingTime(mark, MPR_TEST_SLEEP) > 0);
+    assert(count == TEST_BATCH);
+
+    for (i = 0; i < count; i++) {
+        assert(accepted[i]->fd >= 0);
+        assert(!(accepted[i]->flags & MPR_SOCKET_LISTENER));
+        mprCloseSocket(accepted[i], 0);
+        mprRemoveRoot(accepted[i]);
+    }
+    for (i = 0; i < TEST_BATCH; i++) {
+        mprCloseSocket(clients[i], 0);
+        mprRemoveRoot(clients[i]);
+    }
+    mprCloseSocket(server, 0);
+    mprRemoveRoot(server);
+}
+
+
+/*
+    Open a loopback connection on an ephemeral port. The sockets are added as roots. See closePair.
+ */
+static int openPair(MprSocket **server, MprSocket **client, MprSocket **accepted, int flags)
+{
+    struct sockaddr_in  addr;
+    MprSocklen          addrlen;
+    MprTime             mark;
+
+    *server = mprCreateSocket(NULL);
+    *client = mprCreateSocket(NULL);
+    *accepted = 0;
+    mprAddRoot(*server);
+    mprAddRoot(*client);
+    if (mprListenOnSocket(*server, "127.0.0.1", 0, MPR_SOCKET_NODELAY | flags) < 0) {
+        return MPR_ERR_CANT_OPEN;
+    }
+    addrlen = sizeof(addr);
+    if (getsockname((*server)->fd, (struct sockaddr*) &addr, &addrlen) < 0) {
+        return MPR_ERR_CANT_OPEN;
+    }
+    if (mprConnectSocket(*client, "127.0.0.1", ntohs(addr.sin_port), flags) < 0) {
+        return MPR_ERR_CANT_CONNECT;
+    }
+    mark = mprGetTime();
+    while ((*accepted = mprAcceptSocket(*server)) == 0 && mprGetRemainingTime(mark, MPR_TEST_SLEEP) > 0) {
+        mprNap(10);
+    }
+    if (*accepted == 0) {
+        return MPR_ERR_CANT_CONNECT;
+    }
+    mprAddRoot(*accepted);
+    return 0;
+}
+
+
+static void closePair(MprSocket *server, MprSocket *client, MprSocket *accepted)
+{
+    if (accepted) {
+        mprCloseSocket(accepted, 0);
+        mprRemoveRoot(accepted);
+    }
+    mprCloseSocket(client, 0);
+    mprRemoveRoot(client);
+    mprCloseSocket(server, 0);
+    mprRemoveRoot(server);
+}
+
+
+/*
+    Read until len bytes are received or the test times out. Returns the number of bytes read.
+ */
+static ssize readAll(MprSocket *sp, char *buf, ssize len)
+{
+    MprTime     mark;
+    ssize       nbytes, total;
+
+    mark = mprGetTime();
+    for (total = 0; total < len && mprGetRemainingTime(mark, MPR_TEST_SLEEP) > 0; ) {
+        if ((nbytes = mprReadSocket(sp, &buf[total], len - total)) < 0) {
+            break;
+        } else if (nbytes == 0) {
+            mprNap(10);
+        }
+        total += nbytes;
+    }
+    return total;
+}
+
+
+/*
+    Send from a socket source. Loop as the source data may not have all arrived.
+ */
+static void testSendSocket(MprTestGroup *gp, MprSocket *to, MprSocket *client, char *body)
+{
+    MprSocket   *server, *source, *accepted;
+    MprFile     *file;
+    MprOff      written, total;
+    MprTime     mark;
+    char        buf[TEST_BODY];
+
+    if (openPair(&server, &source, &accepted, 0) < 0) {
+        assert(0);
+        closePair(server, source, accepted);
+        return;
+    }
+    assert(mprWriteSocket(source, body, TEST_BODY) == TEST_BODY);
+    file = mprAttachFileFd(accepted->fd, "socket", O_RDONLY);
+    mark = mprGetTime();
+    for (total = 0; total < TEST_BODY && mprGetRemainingTime(mark, MPR_TEST_SLEEP) > 0; total += written) {
+        if ((written = mprSendFileToSocket(to, file, 0, TEST_BODY - total, NULL, 0, NULL, 0)) <= 0) {
+            written = 0;
+            mprNap(10);
+        }
+    }
+    assert(total == TEST_BODY);
+    assert(readAll(client, buf, TEST_BODY) == TEST_BODY);
+    assert(memcmp(buf, body, TEST_BODY) == 0);
+    closePair(server, source, accepted);
+}
+
+
+/*
+    Send a file with headers and trailers. Then send from a pipe which must be spliced rather than sent via sendfile.
+ */
+static void testSendFile(MprTestGroup *gp)
+{
+    MprSocket   *server, *client, *accepted;
+    MprFile     *file;
+    MprIOVec    before[1], after[1];
+    MprOff      written;
+    char        *path, body[TEST_BODY], expect[TEST_BODY + 16], buf[TEST_BODY + 16];
+    int         i, pfd[2];
+
+    if (openPair(&server, &client, &accepted, 0) < 0) {
+        assert(0);
+        closePair(server, client, accepted);
+        return;
+    }
+    for (i = 0; i < TEST_BODY; i++) {
+        body[i] = 'a' + (i % 26);
+    }
+    path = mprGetTempPath(NULL);
+    assert(path != 0);
+    file = mprOpenFile(path, O_CREAT | O_TRUNC | O_RDWR | O_BINARY, 0664);
+    assert(file != 0);
+    assert(mprWriteFile(file, body, TEST_BODY) == TEST_BODY);
+
+    before[0].start = "HEAD";
+    before[0].len = 4;
+    after[0].start = "TAIL";
+    after[0].len = 4;
+    memcpy(expect, "HEAD", 4);
+    memcpy(&expect[4], body, TEST_BODY);
+    memcpy(&expect[4 + TEST_BODY], "TAIL", 4);
+
+    written = mprSendFileToSocket(accepted, file, 0, TEST_BODY + 8, before, 1, after, 1);
+    assert(written == TEST_BODY + 8);
+    assert(readAll(client, buf, TEST_BODY + 8) == TEST_BODY + 8);
+    assert(memcmp(buf, expect, TEST_BODY + 8) == 0);
+    mprCloseFile(file);
+    mprDeletePath(path);
+
+#if BIT_UNIX_LIKE
+    if (pipe(pfd) == 0) {
+        assert(write(pfd[1], body, TEST_BODY) == TEST_BODY);
+        file = mprAttachFileFd(pfd[0], "pipe", O_RDONLY);
+        written = mprSendFileToSocket(accepted, file, 0, TEST_BODY + 4, before, 1, NULL, 0);
+        assert(written == TEST_BODY + 4);
+        assert(readAll(client, buf, TEST_BODY + 4) == TEST_BODY + 4);
+        assert(memcmp(buf, expect, TEST_BODY + 4) == 0);
+        close(pfd[0]);
+        close(pfd[1]);
+    }
+#endif
+    testSendSocket(gp, accepted, client, body);
+    closePair(server, client, accepted);
+}
+
+
+/*
+    Scatter read into two buffers
+ */
+static void testReadVector(MprTestGroup *gp)
+{
+    MprSocket   *server, *client, *accepted;
+    MprIOVec    iovec[2];
+    MprTime     mark;
+    char        head[4], body[16];
+    ssize       nbytes, total;
+
+    if (openPair(&server, &client, &accepted, 0) < 0) {
+        assert(0);
+        closePair(server, client, accepted);
+        return;
+    }
+    assert(mprWriteSocket(client, "HEADbody", 8) == 8);
+    iovec[0].start = head;
+    iovec[0].len = sizeof(head);
+    iovec[1].start = body;
+    iovec[1].len = sizeof(body);
+    mark = mprGetTime();
+    for (total = 0; total < 8 && mprGetRemainingTime(mark, MPR_TEST_SLEEP) > 0; total += nbytes) {
+        /* All 8 bytes normally arrive together. Retry if not */
+        if ((nbytes = mprReadSocketVector(accepted, iovec, 2)) == 0) {
+            mprNap(10);
+        } else if (nbytes < 8) {
+            total = 8;
+            break;
+        }
+    }
+    assert(total == 8);
+    assert(memcmp(head, "HEAD", 4) == 0);
+    assert(memcmp(body, "body", 4) == 0);
+    closePair(server, client, accepted);
+}
+
+
+/*
+    Sockets owned by a dispatcher skip the socket mutex. Accepted sockets inherit ownership from the listener.
+ */
+static void testOwnedSocket(MprTestGroup *gp)
+{
+    MprSocket   *server, *client, *accepted;
+    char        buf[8];
+
+    if (openPair(&server, &client, &accepted, MPR_SOCKET_OWNED) < 0) {
+        assert(0);
+        closePair(server, client, accepted);
+        return;
+    }
+    assert((client->flags & MPR_SOCKET_OWNED) != 0);
+    assert((accepted->flags & MPR_SOCKET_OWNED) != 0);
+    assert(mprWriteSocket(client, "owned", 5) == 5);
+    assert(readAll(accepted, buf, 5) == 5);
+    assert(memcmp(buf, "owned", 5) == 0);
+    closePair(server, client, accepted);
+}
+
+
+/*
+    Send and receive a batch of datagrams
+ */
+static void testDatagramBatch(MprTestGroup *gp)
+{
+    MprSocket           *server, *client;
+    MprIOVec            msgs[TEST_MESSAGES];
+    struct sockaddr_in  addr;
+    MprSocklen          addrlen;
+    MprTime             mark;
+    char                bufs[TEST_MESSAGES][16], data[TEST_MESSAGES][16];
+    int                 i, count, rc;
+
+    server = mprCreateSocket(NULL);
+    client = mprCreateSocket(NULL);
+    mprAddRoot(server);
+    mprAddRoot(client);
+    rc = mprListenOnSocket(server, "127.0.0.1", 0, MPR_SOCKET_DATAGRAM);
+    assert(rc >= 0);
+    addrlen = sizeof(addr);
+    if (rc >= 0 && getsockname(server->fd, (struct sockaddr*) &addr, &addrlen) == 0) {
+        rc = mprConnectSocket(client, "127.0.0.1", ntohs(addr.sin_port), MPR_SOCKET_DATAGRAM);
+        assert(rc >= 0);
+        for (i = 0; i < TEST_MESSAGES; i++) {
+            mprSprintf(data[i], sizeof(data[i]), "message-%d", i);
+            msgs[i].start = data[i];
+            msgs[i].len = slen(data[i]);
+        }
+        assert(mprWriteSocketMessages(client, msgs, TEST_MESSAGES) == TEST_MESSAGES);
+
+        mark = mprGetTime();
+        for (count = 0; count < TEST_MESSAGES && mprGetRemainingTime(mark, MPR_TEST_SLEEP) > 0; ) {
+            for (i = count; i < TEST_MESSAGES; i++) {
+                msgs[i].start = bufs[i];
+                msgs[i].len = sizeof(bufs[i]);
+            }
+            if ((rc = mprReadSocketMessages(server, &msgs[count], TEST_MESSAGES - count)) <= 0) {
+                mprNap(10);
+                continue;
+            }
+            count += rc;
+        }
+        assert(count == TEST_MESSAGES);
+        for (i = 0; i < count; i++) {
+            assert(msgs[i].len == (ssize) slen(data[i]));
+            assert(memcmp(bufs[i], data[i], msgs[i].len) == 0);
+        }
+        /* An empty queue is not an error. A closed socket is */
+        msgs[0].start = bufs[0];
+        msgs[0].len = sizeof(bufs[0]);
+        assert(mprReadSocketMessages(server, msgs, 1) == 0);
+        mprCloseSocket(client, 0);
+        assert(mprWriteSocketMessages(client, msgs, 1) == MPR_ERR_CANT_WRITE);
+    }
+    mprCloseSocket(client, 0);
+    mprRemoveRoot(client);
+    mprCloseSocket(server, 0);
+    mprRemoveRoot(server);
+}
+
+
+/*
+    The datagram destination is resolved again once the DNS cache lifespan has passed
+ */
+static void testDatagramExpiry(MprTestGroup *gp)
+{
+    MprSocket           *server, *client;
+    MprIOVec            msg;
+    struct sockaddr     *first;
+    struct sockaddr_in  addr;
+    MprSocklen          addrlen;
+    int                 rc;
+
+    server = mprCreateSocket(NULL);
+    client = mprCreateSocket(NULL);
+    mprAddRoot(server);
+    mprAddRoot(client);
+    rc = mprListenOnSocket(server, "127.0.0.1", 0, MPR_SOCKET_DATAGRAM);
+    assert(rc >= 0);
+    addrlen = sizeof(addr);
+    if (rc >= 0 && getsockname(server->fd, (struct sockaddr*) &addr, &addrlen) == 0) {
+        rc = mprConnectSocket(client, "127.0.0.1", ntohs(addr.sin_port), MPR_SOCKET_DATAGRAM);
+        assert(rc >= 0);
+        msg.start = "expiry";
+        msg.len = 6;
+
+        /* Within the lifespan, the address is reused */
+        client->addrExpires = mprGetTime() + 60 * 1000;
+        first = client->addr;
+        assert(mprWriteSocketMessages(client, &msg, 1) == 1);
+        assert(client->addr == first);
+
+        /* Once expired, it is resolved again. Each lookup returns a new copy of the address */
+        client->addrExpires = 0;
+        assert(mprWriteSocketMessages(client, &msg, 1) == 1);
+        assert(client->addr != first);
+        assert(client->addrExpires != 0);
+    }
+    mprCloseSocket(client, 0);
+    mprRemoveRoot(client);
+    mprCloseSocket(server, 0);
+    mprRemoveRoot(server);
+}
+
+
+/*
+    Repeated lookups are served from the address cache. Each caller gets its own copy of the address.
+ */
+static void testDnsCache(MprTestGroup *gp)
+{
+    struct sockaddr     *addr1, *addr2;
+    MprSocklen          len1, len2;
+    int                 family1, family2, protocol1, protocol2;
+
+    assert(mprGetSocketInfo("127.0.0.1", 4100, &family1, &protocol1, &addr1, &len1) == 0);
+    assert(mprGetSocketInfo("127.0.0.1", 4100, &family2, &protocol2, &addr2, &len2) == 0);
+    assert(mprLookupKey(MPR->socketService->dnsCache, "127.0.0.1:4100") != 0);
+    assert(addr1 != addr2);
+    assert(len1 == len2);
+    assert(family1 == family2);
+    assert(protocol1 == protocol2);
+    assert(memcmp(addr1, addr2, len1) == 0);
+}
+
+
 MprTestDef testSocket = {
     "socket", 0, initSocket, termSocket,
     {
@@ -324,6 +730,13 @@ MprTestDef testSocket = {
 #if !WIN
         MPR_TEST(0, testClientServerIPv4),
         MPR_TEST(0, testClientServerIPv6),
+        MPR_TEST(0, testBatchAccept),
+        MPR_TEST(0, testSendFile),
+        MPR_TEST(0, testReadVector),
+        MPR_TEST(0, testOwnedSocket),
+        MPR_TEST(0, testDatagramBatch),
+        MPR_TEST(0, testDatagramExpiry),
+        MPR_TEST(0, testDnsCache),
 #endif
         MPR_TEST(0, testClientSslv4),
         MPR_TEST(0, 0),
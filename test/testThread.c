@@ -8,6 +8,18 @@
 
 #include    "mpr.h"
 
+/*********************************** Locals ***********************************/
+
+typedef struct TestBurst {
+    MprTestGroup    *gp;
+    MprMutex        *mutex;
+    int             count;
+    int             total;
+    int             hold;
+} TestBurst;
+
+static void manageTestBurst(TestBurst *burst, int flags);
+
 /************************************ Code ************************************/
 
 static void workerProc(void *data, MprWorker *thread)
@@ -31,10 +43,160 @@ static void testStartWorker(MprTestGroup *gp)
 }
 
 
+static void manageTestBurst(TestBurst *burst, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(burst->gp);
+        mprMark(burst->mutex);
+    }
+}
+
+
+static void burstProc(TestBurst *burst, MprWorker *worker)
+{
+    int     done;
+
+    mprNap(1);
+    mprLock(burst->mutex);
+    done = (++burst->count == burst->total);
+    mprUnlock(burst->mutex);
+    if (done) {
+        mprSignalTestComplete(burst->gp);
+    }
+}
+
+
+/*
+    Start more tasks than there are workers. The excess must be queued rather than rejected.
+ */
+static void testWorkerBurst(MprTestGroup *gp)
+{
+    TestBurst   *burst;
+    int         i, rc;
+
+    if ((burst = mprAllocObj(TestBurst, manageTestBurst)) == 0) {
+        assert(burst != 0);
+        return;
+    }
+    burst->gp = gp;
+    burst->mutex = mprCreateLock();
+    burst->total = mprGetMaxWorkers() + MPR_WORKER_TASKS;
+    for (i = 0; i < burst->total; i++) {
+        rc = mprStartWorker((MprWorkerProc) burstProc, burst);
+        assert(rc == 0);
+        if (rc != 0) {
+            return;
+        }
+    }
+    assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+    mprLock(burst->mutex);
+    assert(burst->count == burst->total);
+    mprUnlock(burst->mutex);
+}
+
+
+/*
+    Block until the test releases the burst. Used to hold queue waits over the adaptive target.
+ */
+static void holdProc(TestBurst *burst, MprWorker *worker)
+{
+    int     done;
+
+    mprYield(MPR_YIELD_STICKY);
+    while (burst->hold) {
+        mprNap(5);
+    }
+    mprResetYield();
+    mprLock(burst->mutex);
+    done = (++burst->count == burst->total);
+    mprUnlock(burst->mutex);
+    if (done) {
+        mprSignalTestComplete(burst->gp);
+    }
+}
+
+
+/*
+    Wait for the adaptive pool to record a grow or shrink. Returns true if the count changed.
+ */
+static int waitForAdapt(int *counter, int prior)
+{
+    MprTime     mark;
+
+    mark = mprGetTime();
+    mprYield(MPR_YIELD_STICKY);
+    while (*counter == prior && mprGetRemainingTime(mark, 4 * MPR_TIMEOUT_ADAPT) > 0) {
+        mprNap(20);
+    }
+    mprResetYield();
+    return *counter != prior;
+}
+
+
+/*
+    Hold more tasks than the pool limit so the queue wait exceeds the target. The limit must grow. Then release the 
+    tasks and idle. The limit must shrink.
+ */
+static void testWorkerAdapt(MprTestGroup *gp)
+{
+    MprWorkerService    *ws;
+    MprWorkerStats      stats;
+    TestBurst           *burst;
+    MprTime             prior;
+    int                 i, rc, grows, shrinks, limit, grew, shrank;
+
+    if (gp->service->numThreads > 1) {
+        /* Holding the pool would starve other groups and they may be adjusting the target concurrently */
+        return;
+    }
+    if ((burst = mprAllocObj(TestBurst, manageTestBurst)) == 0) {
+        assert(burst != 0);
+        return;
+    }
+    ws = MPR->workerService;
+    mprGetWorkerServiceStats(ws, &stats);
+    prior = stats.targetWait;
+    mprSetWorkerTargetWait(1000);
+    mprGetWorkerServiceStats(ws, &stats);
+    limit = stats.limit;
+    grows = stats.grows;
+
+    burst->gp = gp;
+    burst->mutex = mprCreateLock();
+    burst->hold = 1;
+    burst->total = min(mprGetMaxWorkers(), limit + MPR_WORKER_TASKS);
+    for (i = 0; i < burst->total; i++) {
+        rc = mprStartWorker((MprWorkerProc) holdProc, burst);
+        assert(rc == 0);
+        if (rc != 0) {
+            break;
+        }
+    }
+    grew = waitForAdapt(&ws->grows, grows);
+    shrinks = ws->shrinks;
+    burst->hold = 0;
+    if (i == burst->total) {
+        assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+    }
+    shrank = waitForAdapt(&ws->shrinks, shrinks);
+
+    mprGetWorkerServiceStats(ws, &stats);
+    assert(stats.limit >= stats.minThreads);
+    assert(stats.limit <= stats.maxThreads);
+    if (limit < stats.maxThreads) {
+        assert(grew);
+        assert(shrank);
+    }
+    mprSetWorkerTargetWait(prior);
+}
+
+
 MprTestDef testWorker = {
     "worker", 0, 0, 0,
     {
         MPR_TEST(0, testStartWorker),
+        MPR_TEST(0, testWorkerBurst),
+        MPR_TEST(0, testWorkerAdapt),
         MPR_TEST(0, 0),
     },
 };